@@ -70,74 +70,55 @@ LIST(stats_list);
 
 PROCESS(powertrace_process, "Periodic power output");
 /*---------------------------------------------------------------------------*/
+/* 100 times the percentage of part in whole. Energest times are 64-bit,
+   so this does not overflow however long the node has been running. */
+static unsigned long percent100(uint64_t part, uint64_t whole) {
+  return whole == 0 ? 0 : (unsigned long)(10000 * part / whole);
+}
+/*---------------------------------------------------------------------------*/
 void powertrace_print(char *str) {
-  static unsigned long last_cpu, last_lpm, last_transmit, last_listen;
+  static struct energest_snapshot last;
   static unsigned long last_idle_transmit, last_idle_listen;
 
-  unsigned long cpu, lpm, transmit, listen;
-  unsigned long all_cpu, all_lpm, all_transmit, all_listen;
+  struct energest_snapshot now;
+  uint64_t cpu, lpm, transmit, listen;
+  uint64_t all_cpu, all_lpm, all_transmit, all_listen;
   unsigned long idle_transmit, idle_listen;
   unsigned long all_idle_transmit, all_idle_listen;
 
   static unsigned long seqno;
 
-  unsigned long time, all_time, radio, all_radio;
+  uint64_t time, all_time, radio, all_radio;
 
   struct powertrace_sniff_stats *s;
 
-  energest_flush();
+  energest_snapshot(&now);
 
-  all_cpu = energest_type_time(ENERGEST_TYPE_CPU);
-  all_lpm = energest_type_time(ENERGEST_TYPE_LPM);
-  all_transmit = energest_type_time(ENERGEST_TYPE_TRANSMIT);
-  all_listen = energest_type_time(ENERGEST_TYPE_LISTEN);
+  all_cpu = now.time[ENERGEST_TYPE_CPU];
+  all_lpm = now.time[ENERGEST_TYPE_LPM];
+  all_transmit = now.time[ENERGEST_TYPE_TRANSMIT];
+  all_listen = now.time[ENERGEST_TYPE_LISTEN];
   all_idle_transmit = compower_idle_activity.transmit;
   all_idle_listen = compower_idle_activity.listen;
 
-  cpu = all_cpu - last_cpu;
-  lpm = all_lpm - last_lpm;
-  transmit = all_transmit - last_transmit;
-  listen = all_listen - last_listen;
+  cpu = energest_snapshot_diff(&last, &now, ENERGEST_TYPE_CPU);
+  lpm = energest_snapshot_diff(&last, &now, ENERGEST_TYPE_LPM);
+  transmit = energest_snapshot_diff(&last, &now, ENERGEST_TYPE_TRANSMIT);
+  listen = energest_snapshot_diff(&last, &now, ENERGEST_TYPE_LISTEN);
   idle_transmit = compower_idle_activity.transmit - last_idle_transmit;
   idle_listen = compower_idle_activity.listen - last_idle_listen;
 
-  last_cpu = energest_type_time(ENERGEST_TYPE_CPU);
-  last_lpm = energest_type_time(ENERGEST_TYPE_LPM);
-  last_transmit = energest_type_time(ENERGEST_TYPE_TRANSMIT);
-  last_listen = energest_type_time(ENERGEST_TYPE_LISTEN);
+  last = now;
   last_idle_listen = compower_idle_activity.listen;
   last_idle_transmit = compower_idle_activity.transmit;
 
   radio = transmit + listen;
   time = cpu + lpm;
   all_time = all_cpu + all_lpm;
-  all_radio = energest_type_time(ENERGEST_TYPE_LISTEN) +
-              energest_type_time(ENERGEST_TYPE_TRANSMIT);
-
-  /* printf(
-      "%s %lu P %d.%d %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu "
-      "(radio %d.%02d%% / %d.%02d%% tx %d.%02d%% / %d.%02d%% listen %d.%02d%% "
-      "/ %d.%02d%%)\n",
-      str, clock_time(), linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
-      seqno, all_cpu, all_lpm, all_transmit, all_listen, all_idle_transmit,
-      all_idle_listen, cpu, lpm, transmit, listen, idle_transmit, idle_listen,
-      (int)((100L * (all_transmit + all_listen)) / all_time),
-      (int)((10000L * (all_transmit + all_listen) / all_time) -
-            (100L * (all_transmit + all_listen) / all_time) * 100),
-      (int)((100L * (transmit + listen)) / time),
-      (int)((10000L * (transmit + listen) / time) -
-            (100L * (transmit + listen) / time) * 100),
-      (int)((100L * all_transmit) / all_time),
-      (int)((10000L * all_transmit) / all_time -
-            (100L * all_transmit / all_time) * 100),
-      (int)((100L * transmit) / time),
-      (int)((10000L * transmit) / time - (100L * transmit / time) * 100),
-      (int)((100L * all_listen) / all_time),
-      (int)((10000L * all_listen) / all_time -
-            (100L * all_listen / all_time) * 100),
-      (int)((100L * listen) / time),
-      (int)((10000L * listen) / time - (100L * listen / time) * 100)); */
+  all_radio = all_listen + all_transmit;
 
+  /* Times are printed truncated to an unsigned long, like
+     energest_type_time() returns them */
   printf(
       "str: %s, clock_time: %lu, linkaddr_node_addr: %d.%d, seqno: %lu, "
       "all_cpu: %lu, all_lpm: %lu, all_transmit: %lu, all_listen: %lu, "
@@ -148,24 +129,23 @@ void powertrace_print(char *str) {
       "all_transmit_percentage: %d.%02d%%, transmit_percentage: %d.%02d%%, "
       "all_listen_percentage: %d.%02d%%, listen_percentage: %d.%02d%%\n",
       str, clock_time(), linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
-      seqno, all_cpu, all_lpm, all_transmit, all_listen, all_idle_transmit,
-      all_idle_listen, cpu, lpm, transmit, listen, idle_transmit, idle_listen,
-      (int)((100L * (all_transmit + all_listen)) / all_time),
-      (int)((10000L * (all_transmit + all_listen) / all_time) -
-            (100L * (all_transmit + all_listen) / all_time) * 100),
-      (int)((100L * (transmit + listen)) / time),
-      (int)((10000L * (transmit + listen) / time) -
-            (100L * (transmit + listen) / time) * 100),
-      (int)((100L * all_transmit) / all_time),
-      (int)((10000L * all_transmit) / all_time -
-            (100L * all_transmit / all_time) * 100),
-      (int)((100L * transmit) / time),
-      (int)((10000L * transmit) / time - (100L * transmit / time) * 100),
-      (int)((100L * all_listen) / all_time),
-      (int)((10000L * all_listen) / all_time -
-            (100L * all_listen / all_time) * 100),
-      (int)((100L * listen) / time),
-      (int)((10000L * listen) / time - (100L * listen / time) * 100));
+      seqno, (unsigned long)all_cpu, (unsigned long)all_lpm,
+      (unsigned long)all_transmit, (unsigned long)all_listen,
+      all_idle_transmit, all_idle_listen, (unsigned long)cpu,
+      (unsigned long)lpm, (unsigned long)transmit, (unsigned long)listen,
+      idle_transmit, idle_listen,
+      (int)(percent100(all_radio, all_time) / 100),
+      (int)(percent100(all_radio, all_time) % 100),
+      (int)(percent100(radio, time) / 100),
+      (int)(percent100(radio, time) % 100),
+      (int)(percent100(all_transmit, all_time) / 100),
+      (int)(percent100(all_transmit, all_time) % 100),
+      (int)(percent100(transmit, time) / 100),
+      (int)(percent100(transmit, time) % 100),
+      (int)(percent100(all_listen, all_time) / 100),
+      (int)(percent100(all_listen, all_time) % 100),
+      (int)(percent100(listen, time) / 100),
+      (int)(percent100(listen, time) % 100));
 
   // sprintf(str,
   //         "cpu: %lu, lpm: %lu, transmit: %lu, listen: %lu, idle_listen: %lu "
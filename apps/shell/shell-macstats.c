@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Shell commands for the per-neighbor MAC statistics
+ */
+
+#include "contiki.h"
+#include "shell.h"
+#include "net/mac/mac-stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/* Header plus every entry of the table */
+#define DUMP_SIZE (4 + MAC_STATS_NUM_NEIGHBORS * \
+                   (LINKADDR_SIZE + 2 * (5 + MAC_STATS_DELAY_BUCKETS) + 4))
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_macstats_process, "macstats");
+SHELL_COMMAND(macstats_command,
+	      "macstats",
+	      "macstats [reset]: print or reset the per-neighbor MAC statistics",
+	      &shell_macstats_process);
+PROCESS(shell_macstats_bin_process, "macstats-bin");
+SHELL_COMMAND(macstats_bin_command,
+	      "macstats-bin",
+	      "macstats-bin: output the per-neighbor MAC statistics in binary",
+	      &shell_macstats_bin_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_macstats_process, ev, data)
+{
+  const struct mac_stats *s;
+  char buf[112];
+  int i, j;
+
+  PROCESS_BEGIN();
+
+  if(data != NULL && strcmp(data, "reset") == 0) {
+    mac_stats_reset();
+    PROCESS_EXIT();
+  }
+
+  shell_output_str(&macstats_command,
+                   "addr attempts ok collisions noacks drops airtime(us) "
+                   "delay histogram", "");
+  for(i = 0; (s = mac_stats_get(i)) != NULL; i++) {
+    snprintf(buf, sizeof(buf), "%u.%u %u %u %u %u %u %lu",
+             s->addr.u8[0], s->addr.u8[1],
+             s->attempts, s->successes, s->collisions, s->noacks, s->drops,
+             (unsigned long)s->airtime);
+    for(j = 0; j < MAC_STATS_DELAY_BUCKETS; j++) {
+      snprintf(buf + strlen(buf), sizeof(buf) - strlen(buf),
+                    " %u", s->delay[j]);
+    }
+    shell_output_str(&macstats_command, buf, "");
+  }
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_macstats_bin_process, ev, data)
+{
+  static uint8_t buf[DUMP_SIZE];
+
+  PROCESS_BEGIN();
+
+  shell_output(&macstats_bin_command, buf, mac_stats_dump(buf, sizeof(buf)),
+               "", 0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_macstats_init(void)
+{
+  shell_register_command(&macstats_command);
+  shell_register_command(&macstats_bin_command);
+}
+/*---------------------------------------------------------------------------*/
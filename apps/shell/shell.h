@@ -381,6 +381,7 @@ struct shell_input {
 #include "shell-file.h"
 #include "shell-httpd.h"
 #include "shell-irc.h"
+#include "shell-macstats.h"
 #include "shell-memdebug.h"
 #include "shell-netperf.h"
 #include "shell-netstat.h"
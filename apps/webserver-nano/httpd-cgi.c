@@ -1326,10 +1326,10 @@ static uint16_t c0=0x3ff,c1=0x3ff,c2=0x3ff,c3=0x3ff,c4=0x3ff,c5=0x3ff,c6=0x3ff,c
 	last_send=RTIMER_NOW();
     static const char httpd_cgi_ajaxe1[] HTTPD_STRING_ATTR = "p(%lu,%lu,%lu,%lu);";	
     numprinted += httpd_snprintf(buf+numprinted, sizeof(buf)-numprinted,httpd_cgi_ajaxe1,
-        (10000UL*(energest_total_time[ENERGEST_TYPE_CPU].current - last_cpu))/delta_time,
-        (10000UL*(energest_total_time[ENERGEST_TYPE_LPM].current - last_lpm))/delta_time,
-        (10000UL*(energest_total_time[ENERGEST_TYPE_TRANSMIT].current - last_transmit))/delta_time,
-        (10000UL*(energest_total_time[ENERGEST_TYPE_LISTEN].current - last_listen))/delta_time);
+        (10000UL*((unsigned long)energest_total_time[ENERGEST_TYPE_CPU].current - last_cpu))/delta_time,
+        (10000UL*((unsigned long)energest_total_time[ENERGEST_TYPE_LPM].current - last_lpm))/delta_time,
+        (10000UL*((unsigned long)energest_total_time[ENERGEST_TYPE_TRANSMIT].current - last_transmit))/delta_time,
+        (10000UL*((unsigned long)energest_total_time[ENERGEST_TYPE_LISTEN].current - last_listen))/delta_time);
     last_cpu = energest_total_time[ENERGEST_TYPE_CPU].current;
     last_lpm = energest_total_time[ENERGEST_TYPE_LPM].current;
     last_transmit = energest_total_time[ENERGEST_TYPE_TRANSMIT].current;
@@ -47,57 +47,112 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/* Up to this many blocks, memb_free() finds a block by walking the
+   blocks, which is cheaper than a division on most MCUs */
+#define FREE_WALK_MAX 8
+
+/* Index of the lowest zero bit of a word that is not all ones */
+#if defined(__GNUC__)
+#define FIRST_ZERO(w) __builtin_ctz(~(w))
+#else
+static int
+first_zero(unsigned w)
+{
+  int i;
+
+  for(i = 0; w & 1; i++) {
+    w >>= 1;
+  }
+  return i;
+}
+#define FIRST_ZERO(w) first_zero(w)
+#endif
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
-  memset(m->count, 0, m->num);
+  memset(m->used, 0, MEMB_WORDS(m->num) * sizeof(unsigned));
   memset(m->mem, 0, m->size * m->num);
+  m->count = 0;
+  m->first_free = 0;
+#if MEMB_WITH_STATS
+  m->high_water = 0;
+  m->failures = 0;
+#endif /* MEMB_WITH_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
+  unsigned w;
   int i;
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->count[i] == 0) {
-      /* If this block was unused, we increase the reference count to
-	 indicate that it now is used and return a pointer to the
-	 memory block. */
-      ++(m->count[i]);
-      return (void *)((char *)m->mem + (i * m->size));
+  if(m->count < m->num) {
+    /* Words below first_free are full. There is a free block, so the
+       scan stops at a word with a zero bit inside the block. */
+    for(w = m->first_free; m->used[w] == ~0U; w++);
+    m->first_free = w;
+
+    i = w * MEMB_WORD_BITS + FIRST_ZERO(m->used[w]);
+    m->used[w] |= 1U << (i % MEMB_WORD_BITS);
+    m->count++;
+#if MEMB_WITH_STATS
+    if(m->count > m->high_water) {
+      m->high_water = m->count;
     }
+#endif /* MEMB_WITH_STATS */
+    return (void *)((char *)m->mem + (i * m->size));
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
+#if MEMB_WITH_STATS
+  m->failures++;
+#endif /* MEMB_WITH_STATS */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
 char
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
+  unsigned offset;
+  unsigned i;
+  unsigned w;
+  unsigned bit;
   char *ptr2;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    
-    if(ptr2 == (char *)ptr) {
-      /* We've found to block to which "ptr" points so we decrease the
-	 reference count and return the new value of it. */
-      if(m->count[i] > 0) {
-	/* Make sure that we don't deallocate free memory. */
-	--(m->count[i]);
-      }
-      return m->count[i];
+  /* Find the block to which "ptr" points, it must point to its
+     start. */
+  if(m->num <= FREE_WALK_MAX) {
+    ptr2 = (char *)m->mem;
+    for(i = 0; i < m->num && ptr2 != (char *)ptr; ++i) {
+      ptr2 += m->size;
+    }
+    if(i == m->num) {
+      return -1;
+    }
+  } else {
+    if(!memb_inmemb(m, ptr)) {
+      return -1;
+    }
+    offset = (char *)ptr - (char *)m->mem;
+    i = offset / m->size;
+    if(i * m->size != offset) {
+      return -1;
+    }
+  }
+
+  w = i / MEMB_WORD_BITS;
+  bit = 1U << (i % MEMB_WORD_BITS);
+  /* Make sure that we don't deallocate free memory. */
+  if(m->used[w] & bit) {
+    m->used[w] &= ~bit;
+    m->count--;
+    if(w < m->first_free) {
+      m->first_free = w;
     }
-    ptr2 += m->size;
   }
-  return -1;
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -110,15 +165,20 @@ memb_inmemb(struct memb *m, void *ptr)
 int
 memb_numfree(struct memb *m)
 {
-  int i;
-  int num_free = 0;
-
-  for(i = 0; i < m->num; ++i) {
-    if(m->count[i] == 0) {
-      ++num_free;
-    }
-  }
-
-  return num_free;
+  return m->num - m->count;
+}
+/*---------------------------------------------------------------------------*/
+#if MEMB_WITH_STATS
+int
+memb_high_water(struct memb *m)
+{
+  return m->high_water;
+}
+/*---------------------------------------------------------------------------*/
+int
+memb_failures(struct memb *m)
+{
+  return m->failures;
 }
+#endif /* MEMB_WITH_STATS */
 /** @} */
@@ -48,6 +48,12 @@
  * memory by the memb_alloc() function, and are deallocated with the
  * memb_free() function.
  *
+ * Used blocks are tracked in a bitmap, one bit per block. Allocation
+ * returns the free block with the lowest address, skipping full words
+ * of the bitmap, and deallocation finds the block by pointer
+ * arithmetic, so both take constant time for all but very large
+ * blocks of memory.
+ *
  * @{
  */
 
@@ -65,6 +71,26 @@
 
 #include "sys/cc.h"
 
+/* MEMB_WITH_STATS keeps the highest number of blocks in use and the
+   number of failed allocations of every memory block, at a cost of 4
+   bytes of RAM each. */
+#ifdef MEMB_CONF_WITH_STATS
+#define MEMB_WITH_STATS MEMB_CONF_WITH_STATS
+#else
+#define MEMB_WITH_STATS 0
+#endif
+
+/* Bits per word of the bitmap of used blocks */
+#define MEMB_WORD_BITS (sizeof(unsigned) * 8)
+#define MEMB_WORDS(num) (((num) + MEMB_WORD_BITS - 1) / MEMB_WORD_BITS)
+
+/* Initial high_water and failures of a MEMB() */
+#if MEMB_WITH_STATS
+#define MEMB_STATS_INIT , 0, 0
+#else
+#define MEMB_STATS_INIT
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -87,17 +113,29 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
-        static char CC_CONCAT(name,_memb_count)[num]; \
+        static unsigned CC_CONCAT(name,_memb_used)[MEMB_WORDS(num)]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
-                                          CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          0, 0 MEMB_STATS_INIT}
 
 struct memb {
   unsigned short size;
   unsigned short num;
-  char *count;
+  /* Bit i is set when block i is in use */
+  unsigned *used;
   void *mem;
+  /* Number of blocks in use */
+  unsigned short count;
+  /* No word of used below this one has a free bit */
+  unsigned short first_free;
+#if MEMB_WITH_STATS
+  /* Highest count since memb_init() */
+  unsigned short high_water;
+  /* memb_alloc() calls that found no free block */
+  unsigned short failures;
+#endif /* MEMB_WITH_STATS */
 };
 
 /**
@@ -132,6 +170,19 @@ int memb_inmemb(struct memb *m, void *ptr);
 
 int  memb_numfree(struct memb *m);
 
+#if MEMB_WITH_STATS
+/**
+ * The highest number of blocks that were in use at the same time since
+ * memb_init().
+ */
+int memb_high_water(struct memb *m);
+
+/**
+ * The number of memb_alloc() calls that failed since memb_init().
+ */
+int memb_failures(struct memb *m);
+#endif /* MEMB_WITH_STATS */
+
 /** @} */
 /** @} */
 
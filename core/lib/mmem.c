@@ -45,7 +45,6 @@
 
 
 #include "mmem.h"
-#include "list.h"
 #include "contiki-conf.h"
 #include <string.h>
 
@@ -55,10 +54,140 @@
 #define MMEM_SIZE 4096
 #endif
 
-LIST(mmemlist);
+/* Number of size classes of free blocks. Class c holds the free blocks
+   of 2^c to 2^(c+1) - 1 alignment units, the last class all larger
+   ones. */
+#ifdef MMEM_CONF_CLASSES
+#define MMEM_CLASSES MMEM_CONF_CLASSES
+#else
+#define MMEM_CLASSES 12
+#endif
+
+/* Free blocks of the requested class that mmem_alloc() looks at before
+   it takes one from a larger class */
+#define CLASS_SCAN 4
+
+/*
+ * Every block in the arena starts with a header. A block in use points
+ * back to its struct mmem, so that compaction can update the handle
+ * when it moves the block.
+ */
+struct block {
+  struct mmem *owner;
+  /* Size in bytes, including the header */
+  unsigned int size;
+};
+
+/* A free block, on the list of its size class */
+struct free_block {
+  struct block hdr;
+  struct free_block *next;
+  struct free_block *prev;
+};
+
+#define ALIGN sizeof(void *)
+#define ROUND(n) (((n) + ALIGN - 1) & ~(unsigned int)(ALIGN - 1))
+#define MIN_BLOCK ROUND(sizeof(struct free_block))
+
+static void *arena[MMEM_SIZE / sizeof(void *)];
+#define ARENA_START ((char *)arena)
+#define ARENA_END   ((char *)arena + sizeof(arena))
+
+/* End of the last block. Memory above it has never been used since
+   the last compaction. */
+static char *top;
+/* There is no free block below packed */
+static char *packed;
+static struct free_block *free_lists[MMEM_CLASSES];
+/* Bytes in free blocks */
+static unsigned int free_bytes;
+/* Bytes in blocks in use, including the headers */
+static unsigned int used_bytes;
+
+static unsigned int peak_bytes;
+static unsigned long failures;
+static unsigned long compactions;
+static unsigned long moved_bytes;
+
 unsigned int avail_memory;
-static char memory[MMEM_SIZE];
 
+/*---------------------------------------------------------------------------*/
+static int
+size_class(unsigned int size)
+{
+  int c;
+
+  size /= ALIGN;
+  for(c = 0; size > 1 && c < MMEM_CLASSES - 1; c++) {
+    size >>= 1;
+  }
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_list_add(struct free_block *f)
+{
+  int c = size_class(f->hdr.size);
+
+  f->hdr.owner = NULL;
+  f->prev = NULL;
+  f->next = free_lists[c];
+  if(f->next != NULL) {
+    f->next->prev = f;
+  }
+  free_lists[c] = f;
+  free_bytes += f->hdr.size;
+}
+/*---------------------------------------------------------------------------*/
+static void
+free_list_remove(struct free_block *f)
+{
+  if(f->prev != NULL) {
+    f->prev->next = f->next;
+  } else {
+    free_lists[size_class(f->hdr.size)] = f->next;
+  }
+  if(f->next != NULL) {
+    f->next->prev = f->prev;
+  }
+  free_bytes -= f->hdr.size;
+}
+/*---------------------------------------------------------------------------*/
+/* Take a free block of at least size bytes, splitting off the rest */
+static struct block *
+take_free_block(unsigned int size)
+{
+  struct free_block *f;
+  struct free_block *rest;
+  int c;
+  int i;
+
+  c = size_class(size);
+  for(f = free_lists[c], i = 0; f != NULL && i < CLASS_SCAN;
+      f = f->next, i++) {
+    if(f->hdr.size >= size) {
+      break;
+    }
+  }
+  if(f == NULL || f->hdr.size < size) {
+    /* Every block of a larger class is large enough */
+    for(f = NULL, c++; c < MMEM_CLASSES && f == NULL; c++) {
+      f = free_lists[c];
+    }
+    if(f == NULL) {
+      return NULL;
+    }
+  }
+
+  free_list_remove(f);
+  if(f->hdr.size - size >= MIN_BLOCK) {
+    rest = (struct free_block *)((char *)f + size);
+    rest->hdr.size = f->hdr.size - size;
+    free_list_add(rest);
+    f->hdr.size = size;
+  }
+  return &f->hdr;
+}
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Allocate a managed memory block
@@ -72,6 +201,12 @@ static char memory[MMEM_SIZE];
  *             memory allocated with this function must be deallocated
  *             using the mmem_free() function.
  *
+ *             A free block of the right size class is used if there is
+ *             one, otherwise the block is taken from the end of the
+ *             arena. Only when neither has room, but the free memory
+ *             would suffice, the arena is compacted, which may move
+ *             all other blocks.
+ *
  *             \note This function does NOT return a pointer to the
  *             allocated memory, but a pointer to a structure that
  *             contains information about the managed memory. The
@@ -82,24 +217,44 @@ static char memory[MMEM_SIZE];
 int
 mmem_alloc(struct mmem *m, unsigned int size)
 {
-  /* Check if we have enough memory left for this allocation. */
-  if(avail_memory < size) {
+  struct block *b;
+  unsigned int need;
+
+  m->ptr = NULL;
+  if(size > sizeof(arena)) {
+    failures++;
     return 0;
   }
 
-  /* We had enough memory so we add this memory block to the end of
-     the list of allocated memory blocks. */
-  list_add(mmemlist, m);
+  need = ROUND(sizeof(struct block) + size);
+  if(need < MIN_BLOCK) {
+    need = MIN_BLOCK;
+  }
 
-  /* Set up the pointer so that it points to the first available byte
-     in the memory block. */
-  m->ptr = &memory[MMEM_SIZE - avail_memory];
+  b = take_free_block(need);
+  if(b == NULL) {
+    if((unsigned int)(ARENA_END - top) < need &&
+       (unsigned int)(ARENA_END - top) + free_bytes >= need) {
+      mmem_compact(sizeof(arena));
+    }
+    if((unsigned int)(ARENA_END - top) < need) {
+      failures++;
+      return 0;
+    }
+    b = (struct block *)top;
+    b->size = need;
+    top += need;
+  }
 
-  /* Remember the size of this memory block. */
+  b->owner = m;
+  m->ptr = b + 1;
   m->size = size;
 
-  /* Decrease the amount of available memory. */
-  avail_memory -= size;
+  used_bytes += b->size;
+  if(used_bytes > peak_bytes) {
+    peak_bytes = used_bytes;
+  }
+  avail_memory = sizeof(arena) - used_bytes;
 
   /* Return non-zero to indicate that we were able to allocate
      memory. */
@@ -112,31 +267,134 @@ mmem_alloc(struct mmem *m, unsigned int size)
  * \author     Adam Dunkels
  *
  *             This function deallocates a managed memory block that
- *             previously has been allocated with mmem_alloc().
+ *             previously has been allocated with mmem_alloc(). It
+ *             takes constant time and moves no memory, the space is
+ *             reused by later allocations or reclaimed by
+ *             mmem_compact().
  *
  */
 void
 mmem_free(struct mmem *m)
 {
-  struct mmem *n;
-
-  if(m->next != NULL) {
-    /* Compact the memory after the allocation that is to be removed
-       by moving it downwards. */
-    memmove(m->ptr, m->next->ptr,
-	    &memory[MMEM_SIZE - avail_memory] - (char *)m->next->ptr);
-    
-    /* Update all the memory pointers that points to memory that is
-       after the allocation that is to be removed. */
-    for(n = m->next; n != NULL; n = n->next) {
-      n->ptr = (void *)((char *)n->ptr - m->size);
+  struct block *b;
+
+  if(m->ptr == NULL) {
+    return;
+  }
+  b = (struct block *)m->ptr - 1;
+  m->ptr = NULL;
+
+  used_bytes -= b->size;
+  avail_memory = sizeof(arena) - used_bytes;
+
+  if(used_bytes == 0) {
+    /* Nothing left in use, start over with an empty arena */
+    top = packed = ARENA_START;
+    memset(free_lists, 0, sizeof(free_lists));
+    free_bytes = 0;
+    return;
+  }
+
+  if((char *)b + b->size == top) {
+    top = (char *)b;
+  } else {
+    free_list_add((struct free_block *)b);
+  }
+  if((char *)b < packed) {
+    packed = (char *)b;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Compact the managed memory
+ * \param max  Maximum number of bytes to move
+ * \return     Non-zero if free blocks remain between the blocks in use
+ *
+ *             Blocks in use are moved down over the free blocks, in
+ *             address order, until max bytes have been moved, at least
+ *             one block per call. Calling this function with a small
+ *             max when the system is idle spreads the compaction over
+ *             time. Moved blocks get new MMEM_PTR() values.
+ */
+int
+mmem_compact(unsigned int max)
+{
+  struct block *b;
+  char *dst;
+  char *scan;
+  unsigned int moved = 0;
+
+  /* Find the first free block */
+  for(dst = packed; dst < top && ((struct block *)dst)->owner != NULL;
+      dst += ((struct block *)dst)->size);
+
+  for(scan = dst; scan < top; ) {
+    b = (struct block *)scan;
+    if(b->owner == NULL) {
+      free_list_remove((struct free_block *)b);
+      scan += b->size;
+    } else {
+      if(moved > 0 && moved + b->size > max) {
+        break;
+      }
+      moved += b->size;
+      memmove(dst, scan, b->size);
+      b = (struct block *)dst;
+      b->owner->ptr = b + 1;
+      dst += b->size;
+      scan += b->size;
     }
   }
 
-  avail_memory += m->size;
+  if(scan == top) {
+    top = dst;
+  } else if(dst < scan) {
+    /* The free space collected so far is a single free block */
+    b = (struct block *)dst;
+    b->size = scan - dst;
+    free_list_add((struct free_block *)b);
+  }
+  packed = dst;
+
+  if(moved > 0) {
+    compactions++;
+    moved_bytes += moved;
+  }
+  return free_bytes > 0;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Get usage and fragmentation statistics
+ * \param stats Filled in with the current statistics
+ */
+void
+mmem_stats(struct mmem_stats *stats)
+{
+  struct free_block *f;
+  unsigned int largest;
+  unsigned int avail;
+  int c;
+
+  largest = ARENA_END - top;
+  for(c = 0; c < MMEM_CLASSES; c++) {
+    for(f = free_lists[c]; f != NULL; f = f->next) {
+      if(f->hdr.size > largest) {
+        largest = f->hdr.size;
+      }
+    }
+  }
+  avail = sizeof(arena) - used_bytes;
 
-  /* Remove the memory block from the list. */
-  list_remove(mmemlist, m);
+  stats->size = sizeof(arena);
+  stats->used = used_bytes;
+  stats->peak = peak_bytes;
+  stats->free_blocks = free_bytes;
+  stats->largest_free = largest;
+  stats->fragmentation = avail > 0 ?
+    (unsigned int)((unsigned long)(avail - largest) * 1000 / avail) : 0;
+  stats->failures = failures;
+  stats->compactions = compactions;
+  stats->moved = moved_bytes;
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -155,8 +413,11 @@ mmem_init(void)
   if(inited) {
     return;
   }
-  list_init(mmemlist);
-  avail_memory = MMEM_SIZE;
+  top = packed = ARENA_START;
+  memset(free_lists, 0, sizeof(free_lists));
+  free_bytes = used_bytes = peak_bytes = 0;
+  failures = compactions = moved_bytes = 0;
+  avail_memory = sizeof(arena);
   inited = 1;
 }
 /*---------------------------------------------------------------------------*/
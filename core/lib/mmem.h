@@ -38,11 +38,14 @@
  * \defgroup mmem Managed memory allocator
  *
  * The managed memory allocator is a fragmentation-free memory
- * manager. It keeps the allocated memory free from fragmentation by
- * compacting the memory when blocks are freed. A program that uses
- * the managed memory module cannot be sure that allocated memory
- * stays in place. Therefore, a level of indirection is used: access
- * to allocated memory must always be done using a special macro.
+ * manager. Freed blocks are kept on free lists by size class and
+ * reused by later allocations. The memory is compacted when an
+ * allocation would not fit otherwise, or step by step with
+ * mmem_compact(). A program that uses the managed memory module
+ * cannot be sure that allocated memory stays in place across calls
+ * to mmem_alloc() and mmem_compact(). Therefore, a level of
+ * indirection is used: access to allocated memory must always be done
+ * using a special macro.
  *
  * \note This module has not been heavily tested.
  * @{
@@ -75,16 +78,41 @@
 #define MMEM_PTR(m) (struct mmem *)(m)->ptr
 
 struct mmem {
-  struct mmem *next;
   unsigned int size;
   void *ptr;
 };
 
+/* Statistics of the managed memory, all sizes in bytes */
+struct mmem_stats {
+  /* Size of the managed memory */
+  unsigned int size;
+  /* Memory in allocated blocks, including a small header per block */
+  unsigned int used;
+  /* Highest value of used since mmem_init() */
+  unsigned int peak;
+  /* Memory in free blocks between allocated blocks */
+  unsigned int free_blocks;
+  /* Largest free space that can be allocated without compaction */
+  unsigned int largest_free;
+  /* Share of the free memory outside of the largest free space, in
+     thousandths */
+  unsigned int fragmentation;
+  /* Allocations that failed */
+  unsigned long failures;
+  /* Calls to mmem_compact() that moved memory, including those by
+     mmem_alloc() */
+  unsigned long compactions;
+  /* Memory moved by compaction */
+  unsigned long moved;
+};
+
 /* XXX: tagga minne med "interrupt usage", vilke gr att man r
    speciellt varsam under free(). */
 
 int  mmem_alloc(struct mmem *m, unsigned int size);
 void mmem_free(struct mmem *);
+int  mmem_compact(unsigned int max);
+void mmem_stats(struct mmem_stats *stats);
 void mmem_init(void);
 
 #endif /* MMEM_H_ */
@@ -72,16 +72,16 @@ print_stats(void)
   PRINTA("E %d.%d clock %lu cpu %lu lpm %lu irq %lu gled %lu yled %lu rled %lu tx %lu listen %lu sensors %lu serial %lu\n",
 	 linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
 	 clock_seconds(),
-	 energest_total_time[ENERGEST_TYPE_CPU].current,
-	 energest_total_time[ENERGEST_TYPE_LPM].current,
-	 energest_total_time[ENERGEST_TYPE_IRQ].current,
-	 energest_total_time[ENERGEST_TYPE_LED_GREEN].current,
-	 energest_total_time[ENERGEST_TYPE_LED_YELLOW].current,
-	 energest_total_time[ENERGEST_TYPE_LED_RED].current,
-	 energest_total_time[ENERGEST_TYPE_TRANSMIT].current,
-	 energest_total_time[ENERGEST_TYPE_LISTEN].current,
-	 energest_total_time[ENERGEST_TYPE_SENSORS].current,
-	 energest_total_time[ENERGEST_TYPE_SERIAL].current);
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_CPU].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_LPM].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_IRQ].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_LED_GREEN].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_LED_YELLOW].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_LED_RED].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_TRANSMIT].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_LISTEN].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_SENSORS].current,
+	 (unsigned long)energest_total_time[ENERGEST_TYPE_SERIAL].current);
 #endif /* ENERGEST_CONF_ON */
 }
 /*---------------------------------------------------------------------------*/
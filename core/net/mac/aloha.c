@@ -40,16 +40,12 @@
 #include "net/mac/aloha.h"
 
 #include <stdio.h>
-#include <string.h>
 
-#include "lib/list.h"
-#include "lib/memb.h"
 #include "lib/random.h"
+#include "net/mac/mac-queue.h"
 #include "net/netstack.h"
-#include "net/packetbuf.h"
-#include "net/queuebuf.h"
 #include "sys/clock.h"
-#include "sys/ctimer.h"
+#include "sys/etimer.h"
 
 #define DEBUG 0
 #if DEBUG
@@ -91,345 +87,216 @@
 #define ALOHA_MAX_MAX_FRAME_RETRIES 7
 #endif
 
-/* Packet metadata */
-struct qbuf_metadata {
-  mac_callback_t sent;
-  void *cptr;
-  uint8_t max_transmissions;
-};
+/* Retransmission backoff policy, one of ALOHA_BACKOFF_* in aloha.h */
+#ifdef ALOHA_CONF_BACKOFF_POLICY
+#define ALOHA_BACKOFF_POLICY ALOHA_CONF_BACKOFF_POLICY
+#else
+#define ALOHA_BACKOFF_POLICY ALOHA_BACKOFF_FIXED
+#endif
 
-/* Every neighbor has its own packet queue */
-struct neighbor_queue {
-  struct neighbor_queue *next;
-  linkaddr_t addr;
-  struct ctimer transmit_timer;
-  struct ctimer wait_timer;
-  uint8_t transmissions;
-  LIST_STRUCT(queued_packet_list);
-};
+/* Window of the fixed policy, in backoff periods */
+#ifdef ALOHA_CONF_FIXED_WINDOW
+#define ALOHA_FIXED_WINDOW ALOHA_CONF_FIXED_WINDOW
+#else
+#define ALOHA_FIXED_WINDOW 20
+#endif
 
-/* The maximum number of co-existing neighbor queues */
-#ifdef ALOHA_CONF_MAX_NEIGHBOR_QUEUES
-#define ALOHA_MAX_NEIGHBOR_QUEUES ALOHA_CONF_MAX_NEIGHBOR_QUEUES
+/* Length of one backoff period in clock ticks, when not slotted */
+#ifdef ALOHA_CONF_BACKOFF_PERIOD
+#define ALOHA_BACKOFF_PERIOD ALOHA_CONF_BACKOFF_PERIOD
 #else
-#define ALOHA_MAX_NEIGHBOR_QUEUES 2
-#endif /* ALOHA_CONF_MAX_NEIGHBOR_QUEUES */
+#define ALOHA_BACKOFF_PERIOD 1
+#endif
 
-/* The maximum number of pending packet per neighbor */
-#ifdef ALOHA_CONF_MAX_PACKET_PER_NEIGHBOR
-#define ALOHA_MAX_PACKET_PER_NEIGHBOR ALOHA_CONF_MAX_PACKET_PER_NEIGHBOR
+/* ALOHA_SLOTTED makes aloha_driver use slotted ALOHA: transmissions
+   are aligned to a slot grid on the clock tick counter instead of
+   starting at any point in time (pure ALOHA). slotted_aloha_driver is
+   always slotted. */
+#ifdef ALOHA_CONF_SLOTTED
+#define ALOHA_SLOTTED ALOHA_CONF_SLOTTED
 #else
-#define ALOHA_MAX_PACKET_PER_NEIGHBOR MAX_QUEUED_PACKETS
-#endif /* ALOHA_CONF_MAX_PACKET_PER_NEIGHBOR */
+#define ALOHA_SLOTTED 0
+#endif
 
-#define MAX_QUEUED_PACKETS QUEUEBUF_NUM
-MEMB(neighbor_memb, struct neighbor_queue, ALOHA_MAX_NEIGHBOR_QUEUES);
-MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
-MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
+/* Longest MPDU, in bytes, that must fit in one slot */
+#ifdef ALOHA_CONF_SLOT_FRAME_LEN
+#define ALOHA_SLOT_FRAME_LEN ALOHA_CONF_SLOT_FRAME_LEN
+#else
+#define ALOHA_SLOT_FRAME_LEN 127
+#endif
 
-static void packet_sent(void *ptr, int status, int num_transmissions);
-static void transmit_packet_list(void *ptr);
-/*---------------------------------------------------------------------------*/
-static struct neighbor_queue *neighbor_queue_from_addr(const linkaddr_t *addr) {
-  struct neighbor_queue *n = list_head(neighbor_list);
-  while (n != NULL) {
-    // PRINTF("aloha: neighbor %d.%d - %d.%d\n", n->addr.u8[0], n->addr.u8[1],
-    //        addr->u8[0], addr->u8[1]);
-    if (linkaddr_cmp(&n->addr, addr)) {
-      return n;
-    }
-    n = list_item_next(n);
-  }
-  return NULL;
-}
+/* IEEE 802.15.4 2.4 GHz O-QPSK: 250 kbit/s, i.e. 32 usec per byte. The
+   PHY adds preamble (4), SFD (1) and length (1) bytes to every frame. */
+#define ALOHA_BYTE_AIRTIME_US 32
+#define ALOHA_PHY_OVERHEAD 6
+
+/* ACK turnaround (12 symbols) followed by a 5-byte ACK frame */
+#define ALOHA_ACK_AIRTIME_US \
+  (192 + (ALOHA_PHY_OVERHEAD + 5) * ALOHA_BYTE_AIRTIME_US)
+
+/* Slot duration: airtime of the longest frame plus its ACK. Rounded up
+   to whole clock ticks in init_slot_grid(). */
+#ifdef ALOHA_CONF_SLOT_DURATION_US
+#define ALOHA_SLOT_DURATION_US ALOHA_CONF_SLOT_DURATION_US
+#else
+#define ALOHA_SLOT_DURATION_US                                        \
+  ((ALOHA_PHY_OVERHEAD + ALOHA_SLOT_FRAME_LEN) * ALOHA_BYTE_AIRTIME_US + \
+   ALOHA_ACK_AIRTIME_US)
+#endif
+
+/* Number of slots a (re)transmission is randomly spread over */
+#ifdef ALOHA_CONF_SLOT_WINDOW
+#define ALOHA_SLOT_WINDOW ALOHA_CONF_SLOT_WINDOW
+#else
+#define ALOHA_SLOT_WINDOW 16
+#endif
+
+/* Slot length in clock ticks. Slots start where clock_time() is a
+   multiple of it, so the backoff ctimer itself fires on a boundary. */
+static clock_time_t slot_clocks;
+
+#if ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE
+/* Moving average of the transmission failure rate, 0 (no failures)
+   to 255 (every transmission fails) */
+static uint8_t failure_rate;
+#endif /* ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE */
 /*---------------------------------------------------------------------------*/
-static void transmit_packet_list(void *ptr) {
-  struct neighbor_queue *n = ptr;
-  if (n) {
-    struct rdc_buf_list *q = list_head(n->queued_packet_list);
-    PRINTF("aloha: transmit_packet_list %d %p\n", n->transmissions, q);
-    if (q != NULL) {
-      PRINTF("aloha: preparing number %d %p, queue len %d\n", n->transmissions,
-             q, list_length(n->queued_packet_list));
-      /* Send packets in the neighbor's list */
-      NETSTACK_RDC.send_list(packet_sent, n, q);
-    }
+static void init_slot_grid(void) {
+  slot_clocks = ((uint32_t)ALOHA_SLOT_DURATION_US * CLOCK_SECOND + 999999) /
+                1000000;
+  if (slot_clocks <= 1) {
+    /* Every tick is a boundary, only the backoff ctimer firing at the
+       start of its tick keeps transmissions aligned */
+    slot_clocks = 1;
+    printf("aloha: slot of %u us rounded to one clock tick\n",
+           (unsigned)ALOHA_SLOT_DURATION_US);
   }
+  PRINTF("aloha: slot %u us, %u clock ticks\n",
+         (unsigned)ALOHA_SLOT_DURATION_US, (unsigned)slot_clocks);
 }
 /*---------------------------------------------------------------------------*/
-/**
- * @brief Schedule next transmission
- *
- * @param n
- */
-static void schedule_transmission(struct neighbor_queue *n) {
-  // clock_time_t delay = ((random_rand() % 5) * 5) + 5;
-  clock_time_t backoff = (random_rand()) % 20 + 1;
-  // 8 -> 60ms
-  // 3 ->
-  ctimer_set(&n->transmit_timer, backoff, transmit_packet_list, n);
+/* Clock ticks from now to the start of the next slot. Within a boundary
+   tick its start has already passed, so that is a full slot. */
+static clock_time_t to_next_slot(void) {
+  return slot_clocks - clock_time() % slot_clocks;
 }
 /*---------------------------------------------------------------------------*/
-static void free_packet(struct neighbor_queue *n, struct rdc_buf_list *p,
-                        int status) {
-  if (p != NULL) {
-    /* Remove packet from list and deallocate */
-    list_remove(n->queued_packet_list, p);
-
-    queuebuf_free(p->buf);
-    memb_free(&metadata_memb, p->ptr);
-    memb_free(&packet_memb, p);
-    // PRINTF("aloha: queued_packet, queue length %d, free packets %d\n",
-    //        list_length(n->queued_packet_list), memb_numfree(&packet_memb));
-    if (list_head(n->queued_packet_list) != NULL) {
-      /* There is a next packet. We reset current tx information */
-      n->transmissions = 0;
-      /* Schedule next transmissions */
-      schedule_transmission(n);
-    } else {
-      /* This was the last packet in the queue, we free the neighbor */
-      ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
-    }
+/* slotted_backoff() sets the ctimer of n to expire at the start of a
+   slot, which is when it fires unless it runs late. Transmit only in
+   the very tick it was scheduled for; if the slot has already passed,
+   defer to a later one rather than sending across the grid. This costs
+   no backoff attempt. */
+static int check_slot(struct mac_queue_neighbor *n) {
+  clock_time_t now = clock_time();
+
+  if (now % slot_clocks == 0 &&
+      now == etimer_expiration_time(&n->transmit_timer.etimer)) {
+    return MAC_TX_OK;
   }
+  return MAC_TX_DEFERRED;
 }
 /*---------------------------------------------------------------------------*/
-static void tx_done(int status, struct rdc_buf_list *q,
-                    struct neighbor_queue *n) {
-  mac_callback_t sent;
-  struct qbuf_metadata *metadata;
-  void *cptr;
-  uint8_t ntx;
-
-  metadata = (struct qbuf_metadata *)q->ptr;
-  sent = metadata->sent;
-  cptr = metadata->cptr;
-  ntx = n->transmissions;
-
-  switch (status) {
-    case MAC_TX_OK:
-      // PRINTF("aloha: rexmit ok %d\n", n->transmissions);
-      // printf("aloha: tx_done ok %d\n", n->transmissions);
-      break;
-    case MAC_TX_COLLISION:
-    case MAC_TX_NOACK:
-      // PRINTF("aloha: drop with status %d after %d transmissions\n", status,
-      //        n->transmissions);
-      break;
-    default:
-      // PRINTF("aloha: rexmit failed %d: %d\n", n->transmissions, status);
-      break;
+#if ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE
+static void update_load(const struct mac_queue_neighbor *n, int status) {
+  /* Exponentially weighted, alpha = 1/8 */
+  if (status == MAC_TX_OK) {
+    failure_rate -= failure_rate >> 3;
+  } else if (status == MAC_TX_NOACK || status == MAC_TX_COLLISION) {
+    failure_rate += (255 - failure_rate) >> 3;
   }
-
-  free_packet(n, q, status);
-  mac_call_sent_callback(sent, cptr, status, ntx);
-}
-/*---------------------------------------------------------------------------*/
-static void send_packet_again(struct rdc_buf_list *q,
-                              struct neighbor_queue *n) {
-  schedule_transmission(n);
-  /* This is needed to correctly attribute energy that we spent
-     transmitting this packet. */
-  queuebuf_update_attr_from_packetbuf(q->buf);
 }
+#endif /* ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE */
 /*---------------------------------------------------------------------------*/
-static void noack(struct rdc_buf_list *q, struct neighbor_queue *n,
-                  int num_transmissions) {
-  struct qbuf_metadata *metadata;
-
-  metadata = (struct qbuf_metadata *)q->ptr;
-
-  n->transmissions += num_transmissions;
-
-  if (n->transmissions >= metadata->max_transmissions) {
-    PRINTF("aloha: drop after %d transmissions\n", n->transmissions);
-    tx_done(MAC_TX_NOACK, q, n);
-  } else {
-    // PRINTF("aloha: noack %d\n", n->transmissions);
-    send_packet_again(q, n);
-  }
+/* Random number of backoff units before the next transmission. The
+   fixed policy spreads it over 1..window units, never zero. */
+static uint16_t backoff_units(const struct mac_queue_neighbor *n,
+                              uint16_t window) {
+#if ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_BEB
+  return random_rand() % (1 << n->backoff_exponent);
+#elif ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE
+  uint8_t be;
+
+  /* Under load, start from a larger exponent than macMinBE */
+  be = ALOHA_MIN_BE +
+       ((ALOHA_MAX_BE - ALOHA_MIN_BE) * (uint16_t)failure_rate + 127) / 255;
+  return random_rand() % (1 << MAX(be, n->backoff_exponent));
+#else
+  return random_rand() % window + 1;
+#endif
 }
 /*---------------------------------------------------------------------------*/
-static void tx_ok(struct rdc_buf_list *q, struct neighbor_queue *n,
-                  int num_transmissions) {
-  n->transmissions += num_transmissions;
-  tx_done(MAC_TX_OK, q, n);
+static clock_time_t pure_backoff(const struct mac_queue_neighbor *n) {
+  return backoff_units(n, ALOHA_FIXED_WINDOW) * ALOHA_BACKOFF_PERIOD;
 }
 /*---------------------------------------------------------------------------*/
-static void packet_sent(void *ptr, int status, int num_transmissions) {
-  struct neighbor_queue *n;
-  struct rdc_buf_list *q;
-
-  n = ptr;
-  if (n == NULL) {
-    return;
-  }
-
-  /* Find out what packet this callback refers to */
-  for (q = list_head(n->queued_packet_list); q != NULL; q = list_item_next(q)) {
-    if (queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO) ==
-        packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO)) {
-      break;
-    }
-  }
-
-  if (q == NULL) {
-    PRINTF("aloha: seqno %d not found\n",
-           packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
-    return;
-  } else if (q->ptr == NULL) {
-    PRINTF("aloha: no metadata\n");
-    return;
-  }
+static clock_time_t slotted_backoff(const struct mac_queue_neighbor *n) {
+  uint16_t units = backoff_units(n, ALOHA_SLOT_WINDOW);
 
-  PRINTF("aloha: packet_sent %d %d\n", status, num_transmissions);
-
-  switch (status) {
-    case MAC_TX_OK:
-      // printf("aloha: tx_ok\n");
-      tx_ok(q, n, num_transmissions);
-      break;
-    case MAC_TX_NOACK:
-      PRINTF("aloha: noack received for packet %p\n", q);
-      // printf("aloha: noack received for packet %p\n", q);
-      noack(q, n, num_transmissions);
-      break;
-    case MAC_TX_COLLISION:
-      // collision(q, n, num_transmissions);
-      // PRINTF("aloha: collision on %p\n", q);
-
-      break;
-    case MAC_TX_DEFERRED:
-      break;
-    default:
-      tx_done(status, q, n);
-      break;
-  }
+  return to_next_slot() + units * slot_clocks;
 }
 /*---------------------------------------------------------------------------*/
-static void send_packet(mac_callback_t sent, void *ptr) {
-  struct rdc_buf_list *q;
-  struct neighbor_queue *n;
-  static uint8_t initialized = 0;
-  static uint16_t seqno;
-  const linkaddr_t *addr = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
-
-  if (!initialized) {
-    initialized = 1;
-    /* Initialize the sequence number to a random value as per 802.15.4. */
-    seqno = random_rand();
-  }
-
-  if (seqno == 0) {
-    /* PACKETBUF_ATTR_MAC_SEQNO cannot be zero, due to a pecuilarity
-       in framer-802154.c. */
-    seqno++;
-  }
-  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno++);
-
-  /* Look for the neighbor entry */
-  n = neighbor_queue_from_addr(addr);
-  if (n == NULL) {
-    /* Allocate a new neighbor entry */
-    n = memb_alloc(&neighbor_memb);
-    if (n != NULL) {
-      /* Init neighbor entry */
-      linkaddr_copy(&n->addr, addr);
-      n->transmissions = 0;
-      /* Init packet list for this neighbor */
-      LIST_STRUCT_INIT(n, queued_packet_list);
-      /* Add neighbor to the list */
-      list_add(neighbor_list, n);
-    }
-  }
-
-  if (n != NULL) {
-    /* Add packet to the neighbor's queue */
-    if (list_length(n->queued_packet_list) < ALOHA_MAX_PACKET_PER_NEIGHBOR) {
-      q = memb_alloc(&packet_memb);
-      if (q != NULL) {
-        q->ptr = memb_alloc(&metadata_memb);
-        if (q->ptr != NULL) {
-          q->buf = queuebuf_new_from_packetbuf();
-          if (q->buf != NULL) {
-            struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
-            /* Neighbor and packet successfully allocated */
-            if (packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == 0) {
-              /* Use default configuration for max transmissions */
-              metadata->max_transmissions = ALOHA_MAX_MAX_FRAME_RETRIES;
-            } else {
-              metadata->max_transmissions =
-                  packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS);
-            }
-            metadata->sent = sent;
-            metadata->cptr = ptr;
-#if PACKETBUF_WITH_PACKET_TYPE
-            if (packetbuf_attr(PACKETBUF_ATTR_PACKET_TYPE) ==
-                PACKETBUF_ATTR_PACKET_TYPE_ACK) {
-              list_push(n->queued_packet_list, q);
-            } else
+#if ALOHA_BACKOFF_POLICY == ALOHA_BACKOFF_ADAPTIVE
+#define ALOHA_TX_STATUS update_load
+#else
+#define ALOHA_TX_STATUS NULL
 #endif
-            {
-              list_add(n->queued_packet_list, q);
-            }
 
-            /* PRINTF("aloha: send_packet, queue length %d, free packets %d\n",
-                   list_length(n->queued_packet_list),
-                   memb_numfree(&packet_memb)); */
-            /* If q is the first packet in the neighbor's queue, send asap */
-            if (list_head(n->queued_packet_list) == q) {
-              transmit_packet_list(n);
-            }
-            return;
-          }
-          memb_free(&metadata_memb, q->ptr);
-          // PRINTF("aloha: could not allocate queuebuf, dropping packet\n");
-        }
-        memb_free(&packet_memb, q);
-        // PRINTF("aloha: could not allocate queuebuf, dropping packet\n");
-      }
-      /* The packet allocation failed. Remove and free neighbor entry if empty.
-       */
-      if (list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
-      }
-    } /* else {
-      PRINTF("aloha: Neighbor queue full\n");
-    } */
-    // PRINTF("aloha: could not allocate packet, dropping packet\n");
-  } /* else {
-    PRINTF("aloha: could not allocate neighbor, dropping packet\n");
-  } */
-  mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
-}
-/*---------------------------------------------------------------------------*/
-static void input_packet(void) {
-  NETSTACK_LLSEC.input();
-  // print the packet received
-}
-/*---------------------------------------------------------------------------*/
-static int on(void) { return NETSTACK_RDC.on(); }
-/*---------------------------------------------------------------------------*/
-static int off(int keep_radio_on) { return NETSTACK_RDC.off(keep_radio_on); }
-/*---------------------------------------------------------------------------*/
-static unsigned short channel_check_interval(void) {
-  if (NETSTACK_RDC.channel_check_interval) {
-    return NETSTACK_RDC.channel_check_interval();
-  }
-  return 0;
-}
+/* Binary exponential backoff grows on missing ACKs too, ALOHA has no
+   other sign of contention. Slotted ALOHA waits for a slot boundary
+   even for the first transmission of a packet. */
+#define ALOHA_FLAGS (MAC_QUEUE_SEND_IMMEDIATELY | MAC_QUEUE_BACKOFF_ON_NOACK)
+#define SLOTTED_ALOHA_FLAGS MAC_QUEUE_BACKOFF_ON_NOACK
+
+static const struct mac_queue_policy pure_aloha_policy = {
+    "aloha",
+    NULL,
+    pure_backoff,
+    NULL,
+    ALOHA_TX_STATUS,
+    ALOHA_MIN_BE,
+    ALOHA_MAX_BE,
+    ALOHA_MAX_BACKOFF,
+    ALOHA_MAX_MAX_FRAME_RETRIES,
+    ALOHA_FLAGS,
+};
+
+static const struct mac_queue_policy slotted_aloha_policy = {
+    "slotted-aloha",
+    init_slot_grid,
+    slotted_backoff,
+    check_slot,
+    ALOHA_TX_STATUS,
+    ALOHA_MIN_BE,
+    ALOHA_MAX_BE,
+    ALOHA_MAX_BACKOFF,
+    ALOHA_MAX_MAX_FRAME_RETRIES,
+    SLOTTED_ALOHA_FLAGS,
+};
 /*---------------------------------------------------------------------------*/
 static void init(void) {
-  memb_init(&packet_memb);
-  memb_init(&metadata_memb);
-  memb_init(&neighbor_memb);
-  printf("aloha: clock seconds %lu\n", CLOCK_SECOND);
+  mac_queue_init(ALOHA_SLOTTED ? &slotted_aloha_policy : &pure_aloha_policy);
+  PRINTF("aloha: clock seconds %lu\n", (unsigned long)CLOCK_SECOND);
 }
 /*---------------------------------------------------------------------------*/
+static void init_slotted(void) { mac_queue_init(&slotted_aloha_policy); }
+/*---------------------------------------------------------------------------*/
 const struct mac_driver aloha_driver = {
-    "ALOHA", init, send_packet, input_packet, on, off, channel_check_interval,
+    "ALOHA",
+    init,
+    mac_queue_send,
+    mac_queue_input,
+    mac_queue_on,
+    mac_queue_off,
+    mac_queue_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+const struct mac_driver slotted_aloha_driver = {
+    "S-ALOHA",
+    init_slotted,
+    mac_queue_send,
+    mac_queue_input,
+    mac_queue_on,
+    mac_queue_off,
+    mac_queue_channel_check_interval,
 };
 /*---------------------------------------------------------------------------*/
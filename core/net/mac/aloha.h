@@ -4,6 +4,19 @@
 #include "dev/radio.h"
 #include "net/mac/mac.h"
 
+/* Retransmission backoff policies, selected with
+   ALOHA_CONF_BACKOFF_POLICY */
+/* Uniform delay over a fixed window (classic pure ALOHA) */
+#define ALOHA_BACKOFF_FIXED 0
+/* IEEE 802.15.4 binary exponential backoff, per neighbor */
+#define ALOHA_BACKOFF_BEB 1
+/* Binary exponential backoff with a floor that follows the observed
+   failure rate of all transmissions */
+#define ALOHA_BACKOFF_ADAPTIVE 2
+
+/* Pure ALOHA, or slotted ALOHA with ALOHA_CONF_SLOTTED */
 extern const struct mac_driver aloha_driver;
+/* Slotted ALOHA */
+extern const struct mac_driver slotted_aloha_driver;
 
 #endif /* __ALOHA_H__ */
\ No newline at end of file
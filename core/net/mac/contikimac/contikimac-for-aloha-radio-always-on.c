@@ -497,6 +497,9 @@ static void input_packet(void) {
   original_datalen = packetbuf_datalen();
   original_dataptr = packetbuf_dataptr();
 #endif
+#if PACKETBUF_WITH_PACKET_COST
+  uint16_t frame_len = packetbuf_datalen();
+#endif /* PACKETBUF_WITH_PACKET_COST */
 
   if (packetbuf_datalen() == ACK_LEN) {
     /* Ignore ack packets */
@@ -525,6 +528,11 @@ static void input_packet(void) {
 
       PRINTDEBUG("contikimac-aloha: data (%u)\n", packetbuf_datalen());
 
+#if PACKETBUF_WITH_PACKET_COST
+      /* The radio is on anyway, only the frame and its ACK are charged */
+      compower_attr_rxframe(frame_len, !packetbuf_holds_broadcast());
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
       if (!duplicate) {
         NETSTACK_MAC.input();
       }
@@ -47,12 +47,24 @@
 #include "dev/watchdog.h"
 #include "lib/random.h"
 #include "net/mac/mac-sequence.h"
+#include "net/mac/mac-trace.h"
 #include "net/netstack.h"
 #include "net/rime/rime.h"
 #include "sys/compower.h"
+#include "sys/ctimer.h"
 #include "sys/pt.h"
 #include "sys/rtimer.h"
 
+/* TX/RX cycles are synchronized with neighbor wake periods. The next
+   wake-up of a neighbor is predicted from our own cycle length, so every
+   node must run with the same CCA active time; phase optimization is
+   turned off with DUTY_CYCLE_CONTROL below. */
+#ifdef CONTIKIMAC_ALOHA_CONF_WITH_PHASE_OPTIMIZATION
+#define WITH_PHASE_OPTIMIZATION CONTIKIMAC_ALOHA_CONF_WITH_PHASE_OPTIMIZATION
+#else
+#define WITH_PHASE_OPTIMIZATION 0
+#endif
+
 /* More aggressive radio sleeping when channel is busy with other traffic */
 #ifndef WITH_FAST_SLEEP
 #define WITH_FAST_SLEEP 1
@@ -127,11 +139,13 @@ static int we_are_receiving_burst = 0;
 #define STROBE_TIME (CYCLE_TIME + 2 * CHECK_TIME)
 
 /* GUARD_TIME is the time before the expected phase of a neighbor that
-   a transmitted should begin transmitting packets. */
+   a transmitted should begin transmitting packets. The margin is the
+   one of contikimac.c, whose CHECK_TIME_TX term is zero here as frames
+   are sent without a CCA. */
 #ifdef CONTIKIMAC_CONF_GUARD_TIME
 #define GUARD_TIME CONTIKIMAC_CONF_GUARD_TIME
 #else
-#define GUARD_TIME 10 * CHECK_TIME + CHECK_TIME_TX
+#define GUARD_TIME (10 * CHECK_TIME)
 #endif
 
 /* INTER_PACKET_INTERVAL is the interval between two successive packet
@@ -177,6 +191,42 @@ static int we_are_receiving_burst = 0;
 
 #define RADIO_ALWAYS_ON 0
 
+/* With DUTY_CYCLE_CONTROL, the radio-on time is measured and the active
+   time of each cycle is corrected to hold a target duty cycle, set with
+   contikimac_aloha_set_target_duty_cycle() or the set_duty_cycle()
+   function of the driver. CCA_ACTIVE_TIME is only the initial value. */
+#ifdef CONTIKIMAC_ALOHA_CONF_DUTY_CYCLE_CONTROL
+#define DUTY_CYCLE_CONTROL CONTIKIMAC_ALOHA_CONF_DUTY_CYCLE_CONTROL
+#else
+#define DUTY_CYCLE_CONTROL 0
+#endif
+
+/* The controller sets the active time of each node on its own, so the
+   cycle of a neighbor is not ours and its learned phase would drift */
+#if DUTY_CYCLE_CONTROL && WITH_PHASE_OPTIMIZATION
+#undef WITH_PHASE_OPTIMIZATION
+#define WITH_PHASE_OPTIMIZATION 0
+#endif /* DUTY_CYCLE_CONTROL && WITH_PHASE_OPTIMIZATION */
+
+/* CONTROL_PERIOD is the interval over which the duty cycle is measured
+   before the controller corrects the active time. */
+#ifdef CONTIKIMAC_ALOHA_CONF_CONTROL_PERIOD
+#define CONTROL_PERIOD CONTIKIMAC_ALOHA_CONF_CONTROL_PERIOD
+#else
+#define CONTROL_PERIOD (5 * CLOCK_SECOND)
+#endif
+
+/* Range of duty cycles that can be applied, in RDC_DUTY_CYCLE_SCALE
+   units */
+#define MIN_DUTY_CYCLE 10
+#define MAX_DUTY_CYCLE 8500
+
+/* The start of the next cycle must stay within half of the rtimer range
+   to be compared with RTIMER_CLOCK_LT(). With a 16-bit rtimer and the
+   default CYCLE_TIME this is about 87% duty cycle. */
+#define MAX_CCA_ACTIVE_TIME \
+  ((uint32_t)((rtimer_clock_t)~(rtimer_clock_t)0 >> 1) - CYCLE_TIME)
+
 /* AFTER_ACK_DETECTED_WAIT_TIME is the time to wait after a potential
    ACK packet has been detected until we can read it out from the
    radio. */
@@ -203,6 +253,10 @@ static int we_are_receiving_burst = 0;
 
 #define ACK_LEN 3
 
+#if WITH_PHASE_OPTIMIZATION
+#include "net/mac/phase.h"
+#endif /* WITH_PHASE_OPTIMIZATION */
+
 #include <stdio.h>
 static struct rtimer rt;
 static struct pt pt;
@@ -213,6 +267,22 @@ static volatile uint8_t contikimac_keep_radio_on = 0;
 static volatile unsigned char we_are_sending = 0;
 static volatile unsigned char radio_is_on = 0;
 
+/* Time the radio listens for activity in every cycle, in rtimer ticks */
+static volatile rtimer_clock_t cca_active_time = CCA_ACTIVE_TIME;
+
+#if DUTY_CYCLE_CONTROL
+/* Total radio-on time, in rtimer ticks, accumulated by on() and off() */
+static volatile uint32_t radio_on_time;
+static rtimer_clock_t radio_on_since;
+
+static struct ctimer control_timer;
+static clock_time_t control_start;
+static uint32_t control_start_on_time;
+static uint16_t target_duty_cycle;
+static uint16_t measured_duty_cycle;
+static int32_t commanded_duty_cycle;
+#endif /* DUTY_CYCLE_CONTROL */
+
 #define DEBUG 0
 #if DEBUG
 #include <stdio.h>
@@ -225,6 +295,10 @@ static volatile unsigned char radio_is_on = 0;
 
 #define DEFAULT_STREAM_TIME (4 * CYCLE_TIME)
 
+#if CONTIKIMAC_CONF_COMPOWER
+static struct compower_activity current_packet;
+#endif /* CONTIKIMAC_CONF_COMPOWER */
+
 #if CONTIKIMAC_CONF_BROADCAST_RATE_LIMIT
 static struct timer broadcast_rate_timer;
 static int broadcast_rate_counter;
@@ -234,6 +308,9 @@ static int broadcast_rate_counter;
 static void on(void) {
   if (contikimac_is_on && radio_is_on == 0) {
     radio_is_on = 1;
+#if DUTY_CYCLE_CONTROL
+    radio_on_since = RTIMER_NOW();
+#endif /* DUTY_CYCLE_CONTROL */
     NETSTACK_RADIO.on();
   }
 }
@@ -242,6 +319,9 @@ static void off(void) {
   if (contikimac_is_on && radio_is_on != 0 && contikimac_keep_radio_on == 0) {
     radio_is_on = 0;
     NETSTACK_RADIO.off();
+#if DUTY_CYCLE_CONTROL
+    radio_on_time += (rtimer_clock_t)(RTIMER_NOW() - radio_on_since);
+#endif /* DUTY_CYCLE_CONTROL */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -294,6 +374,7 @@ static void powercycle_turn_radio_off(void) {
 
   if (we_are_sending == 0 && we_are_receiving_burst == 0) {
     off();
+    MAC_TRACE(MAC_TRACE_SLEEP, 0, 0);
 #if CONTIKIMAC_CONF_COMPOWER
     if (was_on && !radio_is_on) {
       compower_accumulate(&compower_idle_activity);
@@ -313,7 +394,7 @@ static void powercycle_wrapper(struct rtimer *t, void *ptr) {
 }
 /*---------------------------------------------------------------------------*/
 static void advance_cycle_start(void) {
-  cycle_start = cycle_start + CYCLE_TIME + CCA_ACTIVE_TIME;
+  cycle_start = cycle_start + CYCLE_TIME + cca_active_time;
 }
 /*---------------------------------------------------------------------------*/
 static char powercycle(struct rtimer *t, void *ptr) {
@@ -328,6 +409,7 @@ static char powercycle(struct rtimer *t, void *ptr) {
     packet_seen = 0;
 
     if (we_are_sending == 0 && we_are_receiving_burst == 0) {
+      MAC_TRACE(MAC_TRACE_WAKE, 0, 0);
       powercycle_turn_radio_on();
       /* Check if a packet is seen in the air. If so, we keep the
            radio on for a while (LISTEN_TIME_AFTER_PACKET_DETECTED) to
@@ -336,12 +418,13 @@ static char powercycle(struct rtimer *t, void *ptr) {
            false positive: a spurious radio interference that was not
            caused by an incoming packet. */
       start = RTIMER_NOW();
-      while (RTIMER_CLOCK_LT(RTIMER_NOW(), (start + CCA_ACTIVE_TIME))) {
+      while (RTIMER_CLOCK_LT(RTIMER_NOW(), (start + cca_active_time))) {
         if (NETSTACK_RADIO.channel_clear() == 0) {
           packet_seen = 1;
           break;
         }
       }
+      MAC_TRACE(MAC_TRACE_CCA, packet_seen, 1);
     }
 
     if (!packet_seen) {
@@ -418,6 +501,131 @@ static char powercycle(struct rtimer *t, void *ptr) {
   PT_END(&pt);
 }
 /*---------------------------------------------------------------------------*/
+/* Active time giving duty_cycle, which must be below
+   RDC_DUTY_CYCLE_SCALE:
+   duty cycle = active / (active + CYCLE_TIME), see duty_cycles.md */
+static uint32_t active_time(uint16_t duty_cycle) {
+  return ((uint32_t)duty_cycle * CYCLE_TIME) /
+         (RDC_DUTY_CYCLE_SCALE - duty_cycle);
+}
+/*---------------------------------------------------------------------------*/
+static void apply_duty_cycle(uint16_t duty_cycle) {
+  uint32_t active;
+
+  if (duty_cycle < MIN_DUTY_CYCLE) {
+    duty_cycle = MIN_DUTY_CYCLE;
+  } else if (duty_cycle > MAX_DUTY_CYCLE) {
+    duty_cycle = MAX_DUTY_CYCLE;
+  }
+
+  active = active_time(duty_cycle);
+  if (active > MAX_CCA_ACTIVE_TIME) {
+    active = MAX_CCA_ACTIVE_TIME;
+  }
+  cca_active_time = active;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t get_duty_cycle(void) {
+  rtimer_clock_t active = cca_active_time;
+
+  return ((uint32_t)active * RDC_DUTY_CYCLE_SCALE) / (CYCLE_TIME + active);
+}
+/*---------------------------------------------------------------------------*/
+#if DUTY_CYCLE_CONTROL
+static uint32_t read_radio_on_time(void) {
+  uint32_t t;
+
+  /* radio_on_time is updated from the rtimer interrupt, and may not be
+     read atomically */
+  do {
+    t = radio_on_time;
+  } while (t != radio_on_time);
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static void control(void *ptr) {
+  uint32_t elapsed;
+  uint32_t on_time;
+  uint32_t measured;
+
+  on_time = read_radio_on_time();
+  elapsed = ((uint32_t)(clock_time_t)(clock_time() - control_start) *
+             RTIMER_ARCH_SECOND) /
+            CLOCK_SECOND;
+
+  if (elapsed > 0) {
+    measured = ((uint64_t)(on_time - control_start_on_time) *
+                RDC_DUTY_CYCLE_SCALE) /
+               elapsed;
+    measured_duty_cycle = MIN(measured, RDC_DUTY_CYCLE_SCALE);
+
+    if (target_duty_cycle != 0 && contikimac_is_on) {
+      /* Integral controller: the radio-on time spent on traffic adds to
+         the idle listening, so correct the commanded split by half of
+         the error in every period. */
+      commanded_duty_cycle +=
+          ((int32_t)target_duty_cycle - measured_duty_cycle) / 2;
+      if (commanded_duty_cycle < MIN_DUTY_CYCLE) {
+        commanded_duty_cycle = MIN_DUTY_CYCLE;
+      } else if (commanded_duty_cycle > MAX_DUTY_CYCLE) {
+        commanded_duty_cycle = MAX_DUTY_CYCLE;
+      }
+      apply_duty_cycle(commanded_duty_cycle);
+      PRINTF("contikimac-aloha: duty cycle %u target %u active %u\n",
+             measured_duty_cycle, target_duty_cycle,
+             (unsigned)cca_active_time);
+    }
+  }
+
+  control_start = clock_time();
+  control_start_on_time = on_time;
+  ctimer_set(&control_timer, CONTROL_PERIOD, control, NULL);
+}
+#endif /* DUTY_CYCLE_CONTROL */
+/*---------------------------------------------------------------------------*/
+void contikimac_aloha_set_target_duty_cycle(uint16_t duty_cycle) {
+#if DUTY_CYCLE_CONTROL
+  target_duty_cycle = MIN(duty_cycle, MAX_DUTY_CYCLE);
+  if (target_duty_cycle != 0) {
+    /* Start from the open-loop split */
+    commanded_duty_cycle = target_duty_cycle;
+    apply_duty_cycle(target_duty_cycle);
+  }
+#else  /* DUTY_CYCLE_CONTROL */
+  if (duty_cycle != 0) {
+    apply_duty_cycle(duty_cycle);
+  }
+#endif /* DUTY_CYCLE_CONTROL */
+}
+/*---------------------------------------------------------------------------*/
+void contikimac_aloha_set_energy_budget(uint32_t budget_uw, uint32_t radio_uw) {
+  uint64_t duty_cycle;
+
+  if (radio_uw == 0) {
+    return;
+  }
+  duty_cycle = ((uint64_t)budget_uw * RDC_DUTY_CYCLE_SCALE) / radio_uw;
+  contikimac_aloha_set_target_duty_cycle(MIN(duty_cycle, MAX_DUTY_CYCLE));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t contikimac_aloha_measured_duty_cycle(void) {
+#if DUTY_CYCLE_CONTROL
+  return measured_duty_cycle;
+#else  /* DUTY_CYCLE_CONTROL */
+  return get_duty_cycle();
+#endif /* DUTY_CYCLE_CONTROL */
+}
+/*---------------------------------------------------------------------------*/
+static int set_duty_cycle(uint16_t duty_cycle) {
+  /* Refuse what the cycle cannot represent rather than clamping it */
+  if (duty_cycle == 0 || duty_cycle > MAX_DUTY_CYCLE ||
+      active_time(duty_cycle) > MAX_CCA_ACTIVE_TIME) {
+    return 0;
+  }
+  contikimac_aloha_set_target_duty_cycle(duty_cycle);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 static int broadcast_rate_drop(void) {
 #if CONTIKIMAC_CONF_BROADCAST_RATE_LIMIT
   if (!timer_expired(&broadcast_rate_timer)) {
@@ -438,16 +646,20 @@ static int broadcast_rate_drop(void) {
 }
 /*---------------------------------------------------------------------------*/
 static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
-                       struct rdc_buf_list *buf_list) {
+                       struct rdc_buf_list *buf_list, int is_receiver_awake) {
   rtimer_clock_t t0;
   uint8_t got_strobe_ack = 0;
   uint8_t is_broadcast = 0;
-  // uint8_t is_known_receiver = 0;
+  uint8_t is_known_receiver = 0;
+#if WITH_PHASE_OPTIMIZATION
+  rtimer_clock_t encounter_time = 0;
+#endif /* WITH_PHASE_OPTIMIZATION */
   int transmit_len;
   int ret;
   uint8_t contikimac_was_on;
   int len;
   uint8_t seqno;
+  uint16_t strobes = 0;
 
   /* Exit if RDC and radio were explicitly turned off */
   if (!contikimac_is_on && !contikimac_keep_radio_on) {
@@ -503,6 +715,23 @@ static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
   transmit_len = packetbuf_totlen();
   NETSTACK_RADIO.prepare(packetbuf_hdrptr(), transmit_len);
 
+  if (!is_broadcast && !is_receiver_awake) {
+#if WITH_PHASE_OPTIMIZATION
+    /* The receiver wakes up once per cycle, which lasts the sleep time
+       plus the active time, the same as ours. Wait for its next wake-up
+       if we have seen one before. */
+    ret = phase_wait(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
+                     CYCLE_TIME + cca_active_time, GUARD_TIME, mac_callback,
+                     mac_callback_ptr, buf_list);
+    if (ret == PHASE_DEFERRED) {
+      return MAC_TX_DEFERRED;
+    }
+    if (ret != PHASE_UNKNOWN) {
+      is_known_receiver = 1;
+    }
+#endif /* WITH_PHASE_OPTIMIZATION */
+  }
+
   /* By setting we_are_sending to one, we ensure that the rtimer
      powercycle interrupt do not interfere with us sending the packet. */
   we_are_sending = 1;
@@ -538,6 +767,8 @@ static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
     on();
   }
   seqno = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+  MAC_TRACE(MAC_TRACE_STROBE_START, seqno,
+            is_broadcast ? 0 : MAC_TRACE_ADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER)));
 
   watchdog_periodic();
   if (is_broadcast) {
@@ -548,6 +779,7 @@ static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
       rtimer_clock_t wt;
 
       NETSTACK_RADIO.transmit(transmit_len);
+      strobes++;
       wt = RTIMER_NOW();
       while (RTIMER_CLOCK_LT(RTIMER_NOW(), wt + INTER_PACKET_INTERVAL)) {
       }
@@ -555,22 +787,43 @@ static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
   } else {
     rtimer_clock_t wt;
 
-    NETSTACK_RADIO.transmit(transmit_len);
-    wt = RTIMER_NOW();
-    while (RTIMER_CLOCK_LT(RTIMER_NOW(), wt + INTER_PACKET_INTERVAL)) {
-    }
+    /* Without a known phase the frame is sent once, and the MAC layer
+       retries after its backoff if the receiver was asleep. With a known
+       phase we strobe from just before the expected wake-up until the
+       frame is acknowledged or MAX_PHASE_STROBE_TIME has passed. */
+    t0 = RTIMER_NOW();
+    do {
+#if WITH_PHASE_OPTIMIZATION
+      rtimer_clock_t txtime = RTIMER_NOW();
+#endif /* WITH_PHASE_OPTIMIZATION */
+
+      watchdog_periodic();
 
-    if (NETSTACK_RADIO.receiving_packet() || NETSTACK_RADIO.pending_packet()) {
-      uint8_t ackbuf[ACK_LEN];
+      NETSTACK_RADIO.transmit(transmit_len);
+      strobes++;
       wt = RTIMER_NOW();
-      while (RTIMER_CLOCK_LT(RTIMER_NOW(), wt + AFTER_ACK_DETECTED_WAIT_TIME)) {
+      while (RTIMER_CLOCK_LT(RTIMER_NOW(), wt + INTER_PACKET_INTERVAL)) {
       }
 
-      len = NETSTACK_RADIO.read(ackbuf, ACK_LEN);
-      if (len == ACK_LEN && seqno == ackbuf[ACK_LEN - 1]) {
-        got_strobe_ack = 1;
+      if (NETSTACK_RADIO.receiving_packet() ||
+          NETSTACK_RADIO.pending_packet()) {
+        uint8_t ackbuf[ACK_LEN];
+        wt = RTIMER_NOW();
+        while (
+            RTIMER_CLOCK_LT(RTIMER_NOW(), wt + AFTER_ACK_DETECTED_WAIT_TIME)) {
+        }
+
+        len = NETSTACK_RADIO.read(ackbuf, ACK_LEN);
+        if (len == ACK_LEN && seqno == ackbuf[ACK_LEN - 1]) {
+          got_strobe_ack = 1;
+          MAC_TRACE(MAC_TRACE_ACK, seqno, 0);
+#if WITH_PHASE_OPTIMIZATION
+          encounter_time = txtime;
+#endif /* WITH_PHASE_OPTIMIZATION */
+        }
       }
-    }
+    } while (!got_strobe_ack && is_known_receiver &&
+             RTIMER_CLOCK_LT(RTIMER_NOW(), t0 + MAX_PHASE_STROBE_TIME));
   }
 
   off();
@@ -586,11 +839,24 @@ static int send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
   } else {
     ret = MAC_TX_OK;
   }
+  MAC_TRACE(MAC_TRACE_STROBE_END, ret, strobes);
+
+#if WITH_PHASE_OPTIMIZATION
+  if (is_known_receiver && got_strobe_ack) {
+    PRINTF("contikimac-aloha: phase hit %d\n",
+           packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[0]);
+  }
+
+  if (!is_broadcast && !is_receiver_awake) {
+    phase_update(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), encounter_time, ret);
+  }
+#endif /* WITH_PHASE_OPTIMIZATION */
+
   return ret;
 }
 /*---------------------------------------------------------------------------*/
 static void qsend_packet(mac_callback_t sent, void *ptr) {
-  int ret = send_packet(sent, ptr, NULL);
+  int ret = send_packet(sent, ptr, NULL, 0);
   if (ret != MAC_TX_DEFERRED) {
     mac_call_sent_callback(sent, ptr, ret, 1);
   }
@@ -602,6 +868,7 @@ static void qsend_list(mac_callback_t sent, void *ptr,
   struct rdc_buf_list *next;
   int ret;
   int pending;
+  int is_receiver_awake;
 
   if (buf_list == NULL) {
     return;
@@ -643,6 +910,8 @@ static void qsend_list(mac_callback_t sent, void *ptr,
     curr = next;
   } while (next != NULL);
 
+  /* The receiver needs to be awoken before we send */
+  is_receiver_awake = 0;
   curr = buf_list;
   do { /* A loop sending a burst of packets from buf_list */
     next = list_item_next(curr);
@@ -653,7 +922,7 @@ static void qsend_list(mac_callback_t sent, void *ptr,
     pending = packetbuf_attr(PACKETBUF_ATTR_PENDING);
 
     /* Send the current packet */
-    ret = send_packet(sent, ptr, curr);
+    ret = send_packet(sent, ptr, curr, is_receiver_awake);
     if (ret != MAC_TX_DEFERRED) {
       mac_call_sent_callback(sent, ptr, ret, 1);
     }
@@ -661,6 +930,7 @@ static void qsend_list(mac_callback_t sent, void *ptr,
     if (ret == MAC_TX_OK) {
       if (next != NULL) {
         /* We're in a burst, no need to wake the receiver up again */
+        is_receiver_awake = 1;
         curr = next;
       }
     } else {
@@ -689,6 +959,9 @@ static void input_packet(void) {
   original_datalen = packetbuf_datalen();
   original_dataptr = packetbuf_dataptr();
 #endif
+#if PACKETBUF_WITH_PACKET_COST && !CONTIKIMAC_CONF_COMPOWER
+  uint16_t frame_len = packetbuf_datalen();
+#endif /* PACKETBUF_WITH_PACKET_COST && !CONTIKIMAC_CONF_COMPOWER */
 
   if (!we_are_receiving_burst) {
     off();
@@ -722,6 +995,20 @@ static void input_packet(void) {
 
       PRINTDEBUG("contikimac-aloha: data (%u)\n", packetbuf_datalen());
 
+#if CONTIKIMAC_CONF_COMPOWER
+      /* Charge the radio-on time of the wake-up and the reception,
+         which the duty cycle would otherwise have slept through */
+      compower_accumulate(&current_packet);
+      compower_attrconv(&current_packet);
+      compower_clear(&current_packet);
+#elif PACKETBUF_WITH_PACKET_COST
+      /* Without compower, only the frame and its ACK are charged */
+      compower_attr_rxframe(frame_len, !packetbuf_holds_broadcast());
+#endif /* CONTIKIMAC_CONF_COMPOWER */
+
+      MAC_TRACE(MAC_TRACE_RX, packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
+                MAC_TRACE_ADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER)));
+
       if (!duplicate) {
         NETSTACK_MAC.input();
       }
@@ -738,10 +1025,20 @@ static void init(void) {
   radio_is_on = 0;
   PT_INIT(&pt);
   contikimac_is_on = 1;
+  mac_trace_init();
+
+#if WITH_PHASE_OPTIMIZATION
+  phase_init();
+#endif /* WITH_PHASE_OPTIMIZATION */
 
   rtimer_set(&rt, RTIMER_NOW() + CYCLE_TIME, 1, powercycle_wrapper, NULL);
 
-  printf("CCA_ACTIVE_TIME: %d\n", CCA_ACTIVE_TIME);
+#if DUTY_CYCLE_CONTROL
+  control_start = clock_time();
+  ctimer_set(&control_timer, CONTROL_PERIOD, control, NULL);
+#endif /* DUTY_CYCLE_CONTROL */
+
+  printf("CCA_ACTIVE_TIME: %u\n", (unsigned)cca_active_time);
   printf("RTIMER_ARCH_SECOND: %u\n", RTIMER_ARCH_SECOND);
   printf("CLOCK_SECOND: %lu\n", CLOCK_SECOND);
   printf("CYCLE_TIME: %u\n", CYCLE_TIME);
@@ -771,13 +1068,17 @@ static int turn_off(int keep_radio_on) {
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Channel check interval in clock ticks: a cycle is the sleep time plus
+   the active time, which set_duty_cycle() and the controller change */
 static unsigned short duty_cycle(void) {
-  return (1ul * CLOCK_SECOND * CYCLE_TIME) / RTIMER_ARCH_SECOND;
+  return (1ul * CLOCK_SECOND * (CYCLE_TIME + cca_active_time)) /
+         RTIMER_ARCH_SECOND;
 }
 /*---------------------------------------------------------------------------*/
 const struct rdc_driver contikimac_aloha_driver_rdc = {
-    "ContikiAlohaMac", init,    qsend_packet, qsend_list,
-    input_packet,      turn_on, turn_off,     duty_cycle,
+    "ContikiAlohaMac", init,           qsend_packet, qsend_list,
+    input_packet,      turn_on,        turn_off,     duty_cycle,
+    set_duty_cycle,    get_duty_cycle,
 };
 /*---------------------------------------------------------------------------*/
 uint16_t contikimac_debug_print(void) { return 0; }
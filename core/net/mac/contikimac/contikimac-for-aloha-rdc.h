@@ -46,4 +46,17 @@
 
 extern const struct rdc_driver contikimac_aloha_driver_rdc;
 
+/* Closed-loop duty cycle control. With CONTIKIMAC_ALOHA_CONF_DUTY_CYCLE_CONTROL
+   set, contikimac_aloha_driver_rdc.set_duty_cycle() sets the target that
+   the controller holds; otherwise it changes the active/sleep split
+   directly. Duty cycle control turns
+   CONTIKIMAC_ALOHA_CONF_WITH_PHASE_OPTIMIZATION off, as the learned
+   wake-up phase of a neighbor assumes that it cycles at our rate. */
+void contikimac_aloha_set_target_duty_cycle(uint16_t duty_cycle);
+/* Hold the average radio power under budget_uw (microwatts), for a radio
+   drawing radio_uw while on */
+void contikimac_aloha_set_energy_budget(uint32_t budget_uw, uint32_t radio_uw);
+/* Radio duty cycle measured over the last control period */
+uint16_t contikimac_aloha_measured_duty_cycle(void);
+
 #endif /* CONTIKIMAC_ALOHA_H */
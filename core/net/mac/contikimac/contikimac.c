@@ -913,6 +913,9 @@ static void input_packet(void) {
   original_datalen = packetbuf_datalen();
   original_dataptr = packetbuf_dataptr();
 #endif
+#if PACKETBUF_WITH_PACKET_COST && !CONTIKIMAC_CONF_COMPOWER
+  uint16_t frame_len = packetbuf_datalen();
+#endif /* PACKETBUF_WITH_PACKET_COST && !CONTIKIMAC_CONF_COMPOWER */
 
   if (!we_are_receiving_burst) {
     off();
@@ -970,6 +973,9 @@ static void input_packet(void) {
       /* Clear the accumulated power consumption so that it is ready
          for the next packet. */
       compower_clear(&current_packet);
+#elif PACKETBUF_WITH_PACKET_COST
+      /* Without compower, only the frame and its ACK are charged */
+      compower_attr_rxframe(frame_len, !packetbuf_holds_broadcast());
 #endif /* CONTIKIMAC_CONF_COMPOWER */
 
       PRINTDEBUG("contikimac: data (%u)\n", packetbuf_datalen());
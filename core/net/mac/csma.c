@@ -39,17 +39,10 @@
 
 #include "net/mac/csma.h"
 
-#include <stdio.h>
-#include <string.h>
-
-#include "lib/list.h"
-#include "lib/memb.h"
 #include "lib/random.h"
+#include "net/mac/mac-queue.h"
 #include "net/netstack.h"
-#include "net/packetbuf.h"
-#include "net/queuebuf.h"
 #include "sys/clock.h"
-#include "sys/ctimer.h"
 
 #define DEBUG 0
 #if DEBUG
@@ -91,56 +84,17 @@
 #define CSMA_MAX_MAX_FRAME_RETRIES 7
 #endif
 
-/* Packet metadata */
-struct qbuf_metadata {
-  mac_callback_t sent;
-  void *cptr;
-  uint8_t max_transmissions;
-};
-
-/* Every neighbor has its own packet queue */
-struct neighbor_queue {
-  struct neighbor_queue *next;
-  linkaddr_t addr;
-  struct ctimer transmit_timer;
-  uint8_t transmissions;
-  uint8_t collisions;
-  LIST_STRUCT(queued_packet_list);
-};
-
-/* The maximum number of co-existing neighbor queues */
-#ifdef CSMA_CONF_MAX_NEIGHBOR_QUEUES
-#define CSMA_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
-#else
-#define CSMA_MAX_NEIGHBOR_QUEUES 2
-#endif /* CSMA_CONF_MAX_NEIGHBOR_QUEUES */
-
-/* The maximum number of pending packet per neighbor */
-#ifdef CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
-#define CSMA_MAX_PACKET_PER_NEIGHBOR CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
+/* Initial transmission probability of p-persistent CSMA, out of
+   CSMA_PERSISTENCE_SCALE. Can be changed with csma_set_persistence(). */
+#ifdef CSMA_CONF_PERSISTENCE
+#define CSMA_PERSISTENCE CSMA_CONF_PERSISTENCE
 #else
-#define CSMA_MAX_PACKET_PER_NEIGHBOR MAX_QUEUED_PACKETS
-#endif /* CSMA_CONF_MAX_PACKET_PER_NEIGHBOR */
+#define CSMA_PERSISTENCE (CSMA_PERSISTENCE_SCALE / 2)
+#endif
 
-#define MAX_QUEUED_PACKETS QUEUEBUF_NUM
-MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
-MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
-MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
+/* Transmission probability of p-persistent CSMA */
+static uint16_t persistence = CSMA_PERSISTENCE;
 
-static void packet_sent(void *ptr, int status, int num_transmissions);
-static void transmit_packet_list(void *ptr);
-/*---------------------------------------------------------------------------*/
-static struct neighbor_queue *neighbor_queue_from_addr(const linkaddr_t *addr) {
-  struct neighbor_queue *n = list_head(neighbor_list);
-  while (n != NULL) {
-    if (linkaddr_cmp(&n->addr, addr)) {
-      return n;
-    }
-    n = list_item_next(n);
-  }
-  return NULL;
-}
 /*---------------------------------------------------------------------------*/
 static clock_time_t backoff_period(void) {
   clock_time_t time;
@@ -157,24 +111,11 @@ static clock_time_t backoff_period(void) {
   return time;
 }
 /*---------------------------------------------------------------------------*/
-static void transmit_packet_list(void *ptr) {
-  struct neighbor_queue *n = ptr;
-  if (n) {
-    struct rdc_buf_list *q = list_head(n->queued_packet_list);
-    if (q != NULL) {
-      PRINTF("csma: preparing number %d %p, queue len %d\n", n->transmissions,
-             q, list_length(n->queued_packet_list));
-      /* Send packets in the neighbor's list */
-      NETSTACK_RDC.send_list(packet_sent, n, q);
-    }
-  }
-}
-/*---------------------------------------------------------------------------*/
-static void schedule_transmission(struct neighbor_queue *n) {
+static clock_time_t backoff(const struct mac_queue_neighbor *n) {
   clock_time_t delay;
   int backoff_exponent; /* BE in IEEE 802.15.4 */
 
-  backoff_exponent = MIN(n->collisions, CSMA_MAX_BE);
+  backoff_exponent = MIN(CSMA_MIN_BE + n->collisions, CSMA_MAX_BE);
 
   /* Compute max delay as per IEEE 802.15.4: 2^BE-1 backoff periods  */
   delay = ((1 << backoff_exponent) - 1) * backoff_period();
@@ -182,284 +123,128 @@ static void schedule_transmission(struct neighbor_queue *n) {
     /* Pick a time for next transmission */
     delay = random_rand() % delay;
   }
-
-  PRINTF("csma: scheduling transmission in %u ticks, NB=%u, BE=%u\n",
-         (unsigned)delay, n->collisions, backoff_exponent);
-  ctimer_set(&n->transmit_timer, delay, transmit_packet_list, n);
+  return delay;
 }
 /*---------------------------------------------------------------------------*/
-static void free_packet(struct neighbor_queue *n, struct rdc_buf_list *p,
-                        int status) {
-  if (p != NULL) {
-    /* Remove packet from list and deallocate */
-    list_remove(n->queued_packet_list, p);
-
-    queuebuf_free(p->buf);
-    memb_free(&metadata_memb, p->ptr);
-    memb_free(&packet_memb, p);
-    PRINTF("csma: free_queued_packet, queue length %d, free packets %d\n",
-           list_length(n->queued_packet_list), memb_numfree(&packet_memb));
-    if (list_head(n->queued_packet_list) != NULL) {
-      /* There is a next packet. We reset current tx information */
-      n->transmissions = 0;
-      n->collisions = CSMA_MIN_BE;
-      /* Schedule next transmissions */
-      schedule_transmission(n);
-    } else {
-      /* This was the last packet in the queue, we free the neighbor */
-      ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
-    }
-  }
-}
-/*---------------------------------------------------------------------------*/
-static void tx_done(int status, struct rdc_buf_list *q,
-                    struct neighbor_queue *n) {
-  mac_callback_t sent;
-  struct qbuf_metadata *metadata;
-  void *cptr;
-  uint8_t ntx;
-
-  metadata = (struct qbuf_metadata *)q->ptr;
-  sent = metadata->sent;
-  cptr = metadata->cptr;
-  ntx = n->transmissions;
-
-  switch (status) {
-    case MAC_TX_OK:
-      PRINTF("csma: rexmit ok %d\n", n->transmissions);
-      break;
-    case MAC_TX_COLLISION:
-    case MAC_TX_NOACK:
-      PRINTF(
-          "csma: drop with status %d after %d transmissions, %d collisions\n",
-          status, n->transmissions, n->collisions);
-      break;
-    default:
-      PRINTF("csma: rexmit failed %d: %d\n", n->transmissions, status);
-      break;
-  }
-
-  free_packet(n, q, status);
-  mac_call_sent_callback(sent, cptr, status, ntx);
+/* p-persistent and non-persistent CSMA sense the channel when the
+   backoff expires. The 802.15.4 policy above leaves that to the RDC. */
+static int channel_clear(void) {
+  return NETSTACK_RADIO.channel_clear() != 0;
 }
 /*---------------------------------------------------------------------------*/
-static void rexmit(struct rdc_buf_list *q, struct neighbor_queue *n) {
-  schedule_transmission(n);
-  /* This is needed to correctly attribute energy that we spent
-     transmitting this packet. */
-  queuebuf_update_attr_from_packetbuf(q->buf);
+/* p-persistent: sense every backoff period until the channel is idle,
+   then transmit with probability p or wait one more period. A busy
+   channel is not a failed attempt, the packet only waits. */
+static clock_time_t persistent_backoff(const struct mac_queue_neighbor *n) {
+  return backoff_period();
 }
 /*---------------------------------------------------------------------------*/
-static void collision(struct rdc_buf_list *q, struct neighbor_queue *n,
-                      int num_transmissions) {
-  struct qbuf_metadata *metadata;
-
-  metadata = (struct qbuf_metadata *)q->ptr;
-
-  n->collisions += num_transmissions;
-
-  if (n->collisions > CSMA_MAX_BACKOFF) {
-    n->collisions = CSMA_MIN_BE;
-    /* Increment to indicate a next retry */
-    n->transmissions++;
+static int persistent_access(struct mac_queue_neighbor *n) {
+  if (!channel_clear()) {
+    PRINTF("csma: p-persistent, channel busy\n");
+    return MAC_TX_DEFERRED;
   }
-
-  if (n->transmissions >= metadata->max_transmissions) {
-    tx_done(MAC_TX_COLLISION, q, n);
-  } else {
-    PRINTF("csma: rexmit collision %d\n", n->transmissions);
-    rexmit(q, n);
+  if (random_rand() % CSMA_PERSISTENCE_SCALE >= persistence) {
+    return MAC_TX_DEFERRED;
   }
+  return MAC_TX_OK;
 }
 /*---------------------------------------------------------------------------*/
-static void noack(struct rdc_buf_list *q, struct neighbor_queue *n,
-                  int num_transmissions) {
-  struct qbuf_metadata *metadata;
-
-  metadata = (struct qbuf_metadata *)q->ptr;
-
-  n->collisions = CSMA_MIN_BE;
-  n->transmissions += num_transmissions;
-
-  if (n->transmissions >= metadata->max_transmissions) {
-    tx_done(MAC_TX_NOACK, q, n);
-  } else {
-    PRINTF("csma: rexmit noack %d\n", n->transmissions);
-    rexmit(q, n);
-  }
+/* Non-persistent: transmit on an idle channel, otherwise sense again
+   after a random delay of up to 2^macMaxBE backoff periods. */
+static clock_time_t nonpersistent_backoff(const struct mac_queue_neighbor *n) {
+  return (1 + random_rand() % (1 << CSMA_MAX_BE)) * backoff_period();
 }
 /*---------------------------------------------------------------------------*/
-static void tx_ok(struct rdc_buf_list *q, struct neighbor_queue *n,
-                  int num_transmissions) {
-  n->collisions = CSMA_MIN_BE;
-  n->transmissions += num_transmissions;
-  tx_done(MAC_TX_OK, q, n);
+static int nonpersistent_access(struct mac_queue_neighbor *n) {
+  if (!channel_clear()) {
+    PRINTF("csma: non-persistent, channel busy\n");
+    return MAC_TX_DEFERRED;
+  }
+  return MAC_TX_OK;
 }
 /*---------------------------------------------------------------------------*/
-static void packet_sent(void *ptr, int status, int num_transmissions) {
-  struct neighbor_queue *n;
-  struct rdc_buf_list *q;
-
-  n = ptr;
-  if (n == NULL) {
-    return;
-  }
-
-  /* Find out what packet this callback refers to */
-  for (q = list_head(n->queued_packet_list); q != NULL; q = list_item_next(q)) {
-    if (queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO) ==
-        packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO)) {
-      break;
-    }
-  }
-
-  if (q == NULL) {
-    PRINTF("csma: seqno %d not found\n",
-           packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
-    return;
-  } else if (q->ptr == NULL) {
-    PRINTF("csma: no metadata\n");
-    return;
-  }
-
-  switch (status) {
-    case MAC_TX_OK:
-      tx_ok(q, n, num_transmissions);
-      break;
-    case MAC_TX_NOACK:
-      noack(q, n, num_transmissions);
-      break;
-    case MAC_TX_COLLISION:
-      collision(q, n, num_transmissions);
-      break;
-    case MAC_TX_DEFERRED:
-      break;
-    default:
-      tx_done(status, q, n);
-      break;
-  }
+void csma_set_persistence(uint16_t p) {
+  /* Zero would never transmit */
+  persistence = MAX(MIN(p, CSMA_PERSISTENCE_SCALE), 1);
 }
 /*---------------------------------------------------------------------------*/
-static void send_packet(mac_callback_t sent, void *ptr) {
-  struct rdc_buf_list *q;
-  struct neighbor_queue *n;
-  static uint8_t initialized = 0;
-  static uint16_t seqno;
-  const linkaddr_t *addr = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
-
-  if (!initialized) {
-    initialized = 1;
-    /* Initialize the sequence number to a random value as per 802.15.4. */
-    seqno = random_rand();
-  }
-
-  if (seqno == 0) {
-    /* PACKETBUF_ATTR_MAC_SEQNO cannot be zero, due to a pecuilarity
-       in framer-802154.c. */
-    seqno++;
-  }
-  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno++);
-
-  /* Look for the neighbor entry */
-  n = neighbor_queue_from_addr(addr);
-  if (n == NULL) {
-    /* Allocate a new neighbor entry */
-    n = memb_alloc(&neighbor_memb);
-    if (n != NULL) {
-      /* Init neighbor entry */
-      linkaddr_copy(&n->addr, addr);
-      n->transmissions = 0;
-      n->collisions = CSMA_MIN_BE;
-      /* Init packet list for this neighbor */
-      LIST_STRUCT_INIT(n, queued_packet_list);
-      /* Add neighbor to the list */
-      list_add(neighbor_list, n);
-    }
-  }
+uint16_t csma_get_persistence(void) { return persistence; }
+/*---------------------------------------------------------------------------*/
+static const struct mac_queue_policy csma_policy = {
+    "csma",
+    NULL,
+    backoff,
+    NULL,
+    NULL,
+    CSMA_MIN_BE,
+    CSMA_MAX_BE,
+    CSMA_MAX_BACKOFF,
+    CSMA_MAX_MAX_FRAME_RETRIES + 1,
+    0,
+};
 
-  if (n != NULL) {
-    /* Add packet to the neighbor's queue */
-    if (list_length(n->queued_packet_list) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
-      q = memb_alloc(&packet_memb);
-      if (q != NULL) {
-        q->ptr = memb_alloc(&metadata_memb);
-        if (q->ptr != NULL) {
-          q->buf = queuebuf_new_from_packetbuf();
-          if (q->buf != NULL) {
-            struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
-            /* Neighbor and packet successfully allocated */
-            if (packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == 0) {
-              /* Use default configuration for max transmissions */
-              metadata->max_transmissions = CSMA_MAX_MAX_FRAME_RETRIES + 1;
-            } else {
-              metadata->max_transmissions =
-                  packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS);
-            }
-            metadata->sent = sent;
-            metadata->cptr = ptr;
-#if PACKETBUF_WITH_PACKET_TYPE
-            if (packetbuf_attr(PACKETBUF_ATTR_PACKET_TYPE) ==
-                PACKETBUF_ATTR_PACKET_TYPE_ACK) {
-              list_push(n->queued_packet_list, q);
-            } else
-#endif
-            {
-              list_add(n->queued_packet_list, q);
-            }
+static const struct mac_queue_policy persistent_policy = {
+    "p-csma",
+    NULL,
+    persistent_backoff,
+    persistent_access,
+    NULL,
+    CSMA_MIN_BE,
+    CSMA_MAX_BE,
+    CSMA_MAX_BACKOFF,
+    CSMA_MAX_MAX_FRAME_RETRIES + 1,
+    MAC_QUEUE_SEND_IMMEDIATELY,
+};
 
-            PRINTF("csma: send_packet, queue length %d, free packets %d\n",
-                   list_length(n->queued_packet_list),
-                   memb_numfree(&packet_memb));
-            /* If q is the first packet in the neighbor's queue, send asap */
-            if (list_head(n->queued_packet_list) == q) {
-              schedule_transmission(n);
-            }
-            return;
-          }
-          memb_free(&metadata_memb, q->ptr);
-          PRINTF("csma: could not allocate queuebuf, dropping packet\n");
-        }
-        memb_free(&packet_memb, q);
-        PRINTF("csma: could not allocate queuebuf, dropping packet\n");
-      }
-      /* The packet allocation failed. Remove and free neighbor entry if empty.
-       */
-      if (list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
-      }
-    } else {
-      PRINTF("csma: Neighbor queue full\n");
-    }
-    PRINTF("csma: could not allocate packet, dropping packet\n");
-  } else {
-    PRINTF("csma: could not allocate neighbor, dropping packet\n");
-  }
-  mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
-}
-/*---------------------------------------------------------------------------*/
-static void input_packet(void) { NETSTACK_LLSEC.input(); }
-/*---------------------------------------------------------------------------*/
-static int on(void) { return NETSTACK_RDC.on(); }
+static const struct mac_queue_policy nonpersistent_policy = {
+    "np-csma",
+    NULL,
+    nonpersistent_backoff,
+    nonpersistent_access,
+    NULL,
+    CSMA_MIN_BE,
+    CSMA_MAX_BE,
+    CSMA_MAX_BACKOFF,
+    CSMA_MAX_MAX_FRAME_RETRIES + 1,
+    MAC_QUEUE_SEND_IMMEDIATELY,
+};
 /*---------------------------------------------------------------------------*/
-static int off(int keep_radio_on) { return NETSTACK_RDC.off(keep_radio_on); }
+static void init(void) { mac_queue_init(&csma_policy); }
 /*---------------------------------------------------------------------------*/
-static unsigned short channel_check_interval(void) {
-  if (NETSTACK_RDC.channel_check_interval) {
-    return NETSTACK_RDC.channel_check_interval();
-  }
-  return 0;
-}
+static void init_persistent(void) { mac_queue_init(&persistent_policy); }
 /*---------------------------------------------------------------------------*/
-static void init(void) {
-  memb_init(&packet_memb);
-  memb_init(&metadata_memb);
-  memb_init(&neighbor_memb);
+static void init_nonpersistent(void) {
+  mac_queue_init(&nonpersistent_policy);
 }
 /*---------------------------------------------------------------------------*/
 const struct mac_driver csma_driver = {
-    "CSMA", init, send_packet, input_packet, on, off, channel_check_interval,
+    "CSMA",
+    init,
+    mac_queue_send,
+    mac_queue_input,
+    mac_queue_on,
+    mac_queue_off,
+    mac_queue_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+const struct mac_driver csma_ppersistent_driver = {
+    "p-CSMA",
+    init_persistent,
+    mac_queue_send,
+    mac_queue_input,
+    mac_queue_on,
+    mac_queue_off,
+    mac_queue_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+const struct mac_driver csma_nonpersistent_driver = {
+    "np-CSMA",
+    init_nonpersistent,
+    mac_queue_send,
+    mac_queue_input,
+    mac_queue_on,
+    mac_queue_off,
+    mac_queue_channel_check_interval,
 };
 /*---------------------------------------------------------------------------*/
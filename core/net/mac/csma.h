@@ -45,6 +45,21 @@
 #include "dev/radio.h"
 
 extern const struct mac_driver csma_driver;
+/* p-persistent CSMA: on an idle channel, transmit with probability p */
+extern const struct mac_driver csma_ppersistent_driver;
+/* Non-persistent CSMA: on a busy channel, sense again after a random
+   backoff */
+extern const struct mac_driver csma_nonpersistent_driver;
+
+/* Scale of the p-persistent transmission probability */
+#define CSMA_PERSISTENCE_SCALE 10000
+
+/**
+ * \brief      Set the transmission probability of p-persistent CSMA
+ * \param p    Probability out of CSMA_PERSISTENCE_SCALE, at least 1
+ */
+void csma_set_persistence(uint16_t p);
+uint16_t csma_get_persistence(void);
 
 const struct mac_driver *csma_init(const struct mac_driver *r);
 
@@ -0,0 +1,855 @@
+/*
+ * Copyright (c) 2010, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Per-neighbor packet queues and retransmissions shared by the
+ *         CSMA and ALOHA MAC layers
+ * \author
+ *         Adam Dunkels <adam@sics.se>
+ */
+
+#include "net/mac/mac-queue.h"
+
+#include <string.h>
+
+#include "lib/list.h"
+#include "lib/memb.h"
+#include "lib/random.h"
+#include "net/mac/mac-trace.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "sys/clock.h"
+#include "sys/ctimer.h"
+#if PACKETBUF_WITH_PACKET_COST
+#include "sys/energy-model.h"
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
+#define DEBUG 0
+#if DEBUG
+#include <stdio.h>
+#define PRINTF(...) printf(__VA_ARGS__)
+#else /* DEBUG */
+#define PRINTF(...)
+#endif /* DEBUG */
+
+/* The queue sizes, and the index and burst options of aloha, were
+   configured per MAC layer before the two shared this engine, so the
+   old names are still honored. */
+
+/* The maximum number of co-existing neighbor queues */
+#if defined(MAC_QUEUE_CONF_MAX_NEIGHBOR_QUEUES)
+#define MAC_QUEUE_MAX_NEIGHBOR_QUEUES MAC_QUEUE_CONF_MAX_NEIGHBOR_QUEUES
+#elif defined(CSMA_CONF_MAX_NEIGHBOR_QUEUES)
+#define MAC_QUEUE_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#elif defined(ALOHA_CONF_MAX_NEIGHBOR_QUEUES)
+#define MAC_QUEUE_MAX_NEIGHBOR_QUEUES ALOHA_CONF_MAX_NEIGHBOR_QUEUES
+#else
+#define MAC_QUEUE_MAX_NEIGHBOR_QUEUES 2
+#endif /* MAC_QUEUE_CONF_MAX_NEIGHBOR_QUEUES */
+
+/* The maximum number of pending packet per neighbor */
+#if defined(MAC_QUEUE_CONF_MAX_PACKET_PER_NEIGHBOR)
+#define MAC_QUEUE_MAX_PACKET_PER_NEIGHBOR MAC_QUEUE_CONF_MAX_PACKET_PER_NEIGHBOR
+#elif defined(CSMA_CONF_MAX_PACKET_PER_NEIGHBOR)
+#define MAC_QUEUE_MAX_PACKET_PER_NEIGHBOR CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
+#elif defined(ALOHA_CONF_MAX_PACKET_PER_NEIGHBOR)
+#define MAC_QUEUE_MAX_PACKET_PER_NEIGHBOR ALOHA_CONF_MAX_PACKET_PER_NEIGHBOR
+#else
+#define MAC_QUEUE_MAX_PACKET_PER_NEIGHBOR MAX_QUEUED_PACKETS
+#endif /* MAC_QUEUE_CONF_MAX_PACKET_PER_NEIGHBOR */
+
+/* Number of buckets of the neighbor index, a power of two */
+#if defined(MAC_QUEUE_CONF_NEIGHBOR_HASH_SIZE)
+#define MAC_QUEUE_NEIGHBOR_HASH_SIZE MAC_QUEUE_CONF_NEIGHBOR_HASH_SIZE
+#elif defined(ALOHA_CONF_NEIGHBOR_HASH_SIZE)
+#define MAC_QUEUE_NEIGHBOR_HASH_SIZE ALOHA_CONF_NEIGHBOR_HASH_SIZE
+#else
+#define MAC_QUEUE_NEIGHBOR_HASH_SIZE 16
+#endif /* MAC_QUEUE_CONF_NEIGHBOR_HASH_SIZE */
+
+/* Number of buckets of the in-flight packet ring, a power of two.
+   Sequence numbers are handed out consecutively, so with at least
+   MAX_QUEUED_PACKETS buckets each bucket normally holds one packet. */
+#if defined(MAC_QUEUE_CONF_INFLIGHT_SIZE)
+#define MAC_QUEUE_INFLIGHT_SIZE MAC_QUEUE_CONF_INFLIGHT_SIZE
+#elif defined(ALOHA_CONF_INFLIGHT_SIZE)
+#define MAC_QUEUE_INFLIGHT_SIZE ALOHA_CONF_INFLIGHT_SIZE
+#else
+#define MAC_QUEUE_INFLIGHT_SIZE 16
+#endif /* MAC_QUEUE_CONF_INFLIGHT_SIZE */
+
+#if (MAC_QUEUE_NEIGHBOR_HASH_SIZE & (MAC_QUEUE_NEIGHBOR_HASH_SIZE - 1)) != 0
+#error MAC_QUEUE_CONF_NEIGHBOR_HASH_SIZE must be a power of two
+#endif
+#if (MAC_QUEUE_INFLIGHT_SIZE & (MAC_QUEUE_INFLIGHT_SIZE - 1)) != 0
+#error MAC_QUEUE_CONF_INFLIGHT_SIZE must be a power of two
+#endif
+
+/* MAC_QUEUE_WITH_BURST sends the frames queued for a neighbor
+   back-to-back. The RDC layer sets the pending bit on every frame of the
+   list that is followed by another one, keeping the receiver awake, and
+   sends the next frame as soon as the previous one is acknowledged. The
+   MAC then must not back off between the frames of such a burst. A frame
+   that was already created and secured when it was alone in the queue
+   keeps its cleared pending bit, and ends the burst. */
+#if defined(MAC_QUEUE_CONF_WITH_BURST)
+#define MAC_QUEUE_WITH_BURST MAC_QUEUE_CONF_WITH_BURST
+#elif defined(ALOHA_CONF_WITH_BURST)
+#define MAC_QUEUE_WITH_BURST ALOHA_CONF_WITH_BURST
+#else
+#define MAC_QUEUE_WITH_BURST 0
+#endif /* MAC_QUEUE_CONF_WITH_BURST */
+
+/* Number of traffic classes, see PACKETBUF_ATTR_MAC_PRIORITY */
+#define MAC_QUEUE_NUM_CLASSES 3
+
+/* Maximum time a packet of each class may wait in the queue, in clock
+   ticks. A packet that is still queued when it expires is dropped with
+   MAC_TX_ERR instead of being (re)transmitted, so that a stale frame
+   does not keep the ones behind it waiting. Zero disables the
+   deadline. */
+#ifdef MAC_QUEUE_CONF_MAX_AGE_HIGH
+#define MAC_QUEUE_MAX_AGE_HIGH MAC_QUEUE_CONF_MAX_AGE_HIGH
+#else
+#define MAC_QUEUE_MAX_AGE_HIGH 0
+#endif
+#ifdef MAC_QUEUE_CONF_MAX_AGE_NORMAL
+#define MAC_QUEUE_MAX_AGE_NORMAL MAC_QUEUE_CONF_MAX_AGE_NORMAL
+#else
+#define MAC_QUEUE_MAX_AGE_NORMAL 0
+#endif
+#ifdef MAC_QUEUE_CONF_MAX_AGE_LOW
+#define MAC_QUEUE_MAX_AGE_LOW MAC_QUEUE_CONF_MAX_AGE_LOW
+#else
+#define MAC_QUEUE_MAX_AGE_LOW 0
+#endif
+
+/* Indexed by class, highest priority first */
+static const clock_time_t max_age[MAC_QUEUE_NUM_CLASSES] = {
+    MAC_QUEUE_MAX_AGE_HIGH, MAC_QUEUE_MAX_AGE_NORMAL, MAC_QUEUE_MAX_AGE_LOW,
+};
+
+/* Packet metadata */
+struct qbuf_metadata {
+  mac_callback_t sent;
+  void *cptr;
+  /* Neighbor queue the packet is on */
+  struct mac_queue_neighbor *owner;
+  /* Next packet in the same in-flight bucket */
+  struct rdc_buf_list *next_inflight;
+  packetbuf_attr_t seqno;
+  uint8_t max_transmissions;
+  /* Traffic class, 0 is served first */
+  uint8_t class;
+  clock_time_t queued_at;
+#if PACKETBUF_WITH_PACKET_COST
+  /* Radio energy spent on all transmissions so far, in nanojoules */
+  uint32_t energy;
+#endif /* PACKETBUF_WITH_PACKET_COST */
+};
+
+#define MAX_QUEUED_PACKETS QUEUEBUF_NUM
+MEMB(neighbor_memb, struct mac_queue_neighbor, MAC_QUEUE_MAX_NEIGHBOR_QUEUES);
+MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
+MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
+
+/* Neighbor queues, hashed on the link-layer address */
+static struct mac_queue_neighbor *neighbor_hash[MAC_QUEUE_NEIGHBOR_HASH_SIZE];
+/* Queued packets, indexed on the low bits of their MAC sequence number */
+static struct rdc_buf_list *inflight[MAC_QUEUE_INFLIGHT_SIZE];
+
+static const struct mac_queue_policy *policy;
+
+static void packet_sent(void *ptr, int status, int num_transmissions);
+static void transmit_packet_list(void *ptr);
+static void collision(struct rdc_buf_list *q, struct mac_queue_neighbor *n,
+                      int num_transmissions);
+static void tx_done(int status, struct rdc_buf_list *q,
+                    struct mac_queue_neighbor *n);
+/*---------------------------------------------------------------------------*/
+static uint8_t neighbor_hash_index(const linkaddr_t *addr) {
+  uint8_t h = 0;
+  uint8_t i;
+
+  /* The last bytes of the address vary most between neighbors */
+  for (i = 0; i < LINKADDR_SIZE; i++) {
+    h = (h << 3) ^ (h >> 5) ^ addr->u8[i];
+  }
+  return h & (MAC_QUEUE_NEIGHBOR_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static struct mac_queue_neighbor *neighbor_queue_from_addr(
+    const linkaddr_t *addr) {
+  struct mac_queue_neighbor *n = neighbor_hash[neighbor_hash_index(addr)];
+  while (n != NULL) {
+    if (linkaddr_cmp(&n->addr, addr)) {
+      return n;
+    }
+    n = n->next;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void neighbor_queue_add(struct mac_queue_neighbor *n) {
+  uint8_t h = neighbor_hash_index(&n->addr);
+
+  n->next = neighbor_hash[h];
+  neighbor_hash[h] = n;
+}
+/*---------------------------------------------------------------------------*/
+static void neighbor_queue_remove(struct mac_queue_neighbor *n) {
+  struct mac_queue_neighbor **np =
+      &neighbor_hash[neighbor_hash_index(&n->addr)];
+
+  while (*np != NULL) {
+    if (*np == n) {
+      *np = n->next;
+      break;
+    }
+    np = &(*np)->next;
+  }
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
+static void inflight_add(struct rdc_buf_list *q) {
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+  uint8_t i = metadata->seqno & (MAC_QUEUE_INFLIGHT_SIZE - 1);
+
+  metadata->next_inflight = inflight[i];
+  inflight[i] = q;
+}
+/*---------------------------------------------------------------------------*/
+static void inflight_remove(struct rdc_buf_list *q) {
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+  struct rdc_buf_list **qp;
+
+  qp = &inflight[metadata->seqno & (MAC_QUEUE_INFLIGHT_SIZE - 1)];
+  while (*qp != NULL) {
+    if (*qp == q) {
+      *qp = metadata->next_inflight;
+      break;
+    }
+    qp = &((struct qbuf_metadata *)(*qp)->ptr)->next_inflight;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Sequence numbers are only unique per neighbor, and a stale callback
+   may carry one that has since been reused, so match the owner too */
+static struct rdc_buf_list *inflight_lookup(struct mac_queue_neighbor *n,
+                                            packetbuf_attr_t seqno) {
+  struct rdc_buf_list *q = inflight[seqno & (MAC_QUEUE_INFLIGHT_SIZE - 1)];
+  while (q != NULL) {
+    struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+    if (metadata->seqno == seqno && metadata->owner == n) {
+      return q;
+    }
+    q = metadata->next_inflight;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#if MAC_STATS_ON
+/* The entry of n, looked up again if it was recycled for another
+   neighbor while n was queued */
+static struct mac_stats *neighbor_stats(struct mac_queue_neighbor *n) {
+  if (!linkaddr_cmp(&n->stats->addr, &n->addr)) {
+    n->stats = mac_stats_lookup(&n->addr);
+  }
+  return n->stats;
+}
+#endif /* MAC_STATS_ON */
+/*---------------------------------------------------------------------------*/
+#if PACKETBUF_WITH_PACKET_COST
+static void mark_radio_time(struct mac_queue_neighbor *n) {
+  energest_flush();
+  n->listen_mark = energest_type_time(ENERGEST_TYPE_LISTEN);
+  n->transmit_mark = energest_type_time(ENERGEST_TYPE_TRANSMIT);
+}
+/*---------------------------------------------------------------------------*/
+/* Charge the radio time since the last mark of n to q. The radio serves
+   one neighbor queue at a time, so all of it was spent on q: CCAs,
+   strobes, the frame itself and waiting for its ACK. */
+static void account_energy(struct rdc_buf_list *q,
+                           struct mac_queue_neighbor *n) {
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+  unsigned long listen = n->listen_mark;
+  unsigned long transmit = n->transmit_mark;
+  uint64_t energy;
+
+  mark_radio_time(n);
+  energy = metadata->energy +
+           energy_model_energy(ENERGEST_TYPE_LISTEN, n->listen_mark - listen) +
+           energy_model_energy(ENERGEST_TYPE_TRANSMIT,
+                               n->transmit_mark - transmit);
+  metadata->energy = energy > 0xffffffff ? 0xffffffff : (uint32_t)energy;
+}
+/*---------------------------------------------------------------------------*/
+/* Report the cost of q to the upper layer, in the packetbuf attributes */
+static void set_cost_attrs(struct rdc_buf_list *q) {
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+  clock_time_t age = clock_time() - metadata->queued_at;
+  uint32_t energy = metadata->energy / 1000;
+  uint32_t latency = (uint32_t)age * 1000 / CLOCK_SECOND;
+
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ENERGY,
+                     energy > 0xffff ? 0xffff : energy);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_LATENCY,
+                     latency > 0xffff ? 0xffff : latency);
+}
+#endif /* PACKETBUF_WITH_PACKET_COST */
+/*---------------------------------------------------------------------------*/
+/* Traffic class of the packet in the packetbuf. ACKs are always sent
+   ahead of data, as they were pushed to the head of the queue before
+   there were classes. */
+static uint8_t packet_class(void) {
+#if PACKETBUF_WITH_PACKET_TYPE
+  if (packetbuf_attr(PACKETBUF_ATTR_PACKET_TYPE) ==
+      PACKETBUF_ATTR_PACKET_TYPE_ACK) {
+    return 0;
+  }
+#endif
+  switch (packetbuf_attr(PACKETBUF_ATTR_MAC_PRIORITY)) {
+    case PACKETBUF_ATTR_MAC_PRIORITY_HIGH:
+      return 0;
+    case PACKETBUF_ATTR_MAC_PRIORITY_LOW:
+      return 2;
+    default:
+      return 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Queue q behind all packets of the same or a higher class. A head
+   that is with the RDC layer is never overtaken. A head that is only
+   backing off is; it keeps the transmissions it already used. */
+static void enqueue(struct mac_queue_neighbor *n, struct rdc_buf_list *q) {
+  struct rdc_buf_list *prev;
+  struct rdc_buf_list *next;
+  uint8_t class = ((struct qbuf_metadata *)q->ptr)->class;
+
+  prev = NULL;
+  for (next = list_head(n->queued_packet_list); next != NULL;
+       next = list_item_next(next)) {
+    if ((prev != NULL || !n->in_rdc) &&
+        ((struct qbuf_metadata *)next->ptr)->class > class) {
+      break;
+    }
+    prev = next;
+  }
+  if (prev != NULL) {
+    list_insert(n->queued_packet_list, prev, q);
+    return;
+  }
+  if (next != NULL) {
+    /* n->transmissions counts for the head only */
+    ((struct qbuf_metadata *)next->ptr)->max_transmissions -= n->transmissions;
+    n->transmissions = 0;
+  }
+  list_push(n->queued_packet_list, q);
+}
+/*---------------------------------------------------------------------------*/
+static int packet_expired(struct rdc_buf_list *q) {
+  struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+  clock_time_t age = max_age[metadata->class];
+
+  return age != 0 && (clock_time_t)(clock_time() - metadata->queued_at) > age;
+}
+/*---------------------------------------------------------------------------*/
+static void reset_backoff(struct mac_queue_neighbor *n) {
+  n->collisions = 0;
+  n->backoff_exponent = policy->min_be;
+}
+/*---------------------------------------------------------------------------*/
+static void increase_backoff(struct mac_queue_neighbor *n) {
+  if (n->backoff_exponent < policy->max_be) {
+    n->backoff_exponent++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Drop every packet queued to n that waited longer than its class
+   allows, not only the head. The callbacks run last, when the queue is
+   consistent again. Returns 0 if the queue is empty and n was freed. */
+static int drop_expired(struct mac_queue_neighbor *n) {
+  struct rdc_buf_list *head = list_head(n->queued_packet_list);
+  struct rdc_buf_list *expired = NULL;
+  struct rdc_buf_list *last = NULL;
+  struct rdc_buf_list *q;
+  struct rdc_buf_list *next;
+  struct qbuf_metadata *metadata;
+  uint8_t head_transmissions = n->transmissions;
+  mac_callback_t sent;
+  void *cptr;
+  int alive = 1;
+
+  for (q = head; q != NULL; q = next) {
+    next = list_item_next(q);
+    if (!packet_expired(q)) {
+      continue;
+    }
+    PRINTF("%s: dropping stale packet %p\n", policy->name, q);
+    metadata = (struct qbuf_metadata *)q->ptr;
+#if MAC_STATS_ON
+    mac_stats_done(neighbor_stats(n), MAC_TX_ERR, metadata->queued_at);
+#endif /* MAC_STATS_ON */
+    list_remove(n->queued_packet_list, q);
+    inflight_remove(q);
+    /* Out of the in-flight index, next_inflight chains the dropped */
+    metadata->next_inflight = NULL;
+    if (last == NULL) {
+      expired = q;
+    } else {
+      ((struct qbuf_metadata *)last->ptr)->next_inflight = q;
+    }
+    last = q;
+  }
+
+  if (expired == NULL) {
+    return 1;
+  }
+  if (list_head(n->queued_packet_list) == NULL) {
+    ctimer_stop(&n->transmit_timer);
+    neighbor_queue_remove(n);
+    alive = 0;
+  } else if (list_head(n->queued_packet_list) != head) {
+    n->transmissions = 0;
+    reset_backoff(n);
+  }
+
+  while (expired != NULL) {
+    q = expired;
+    metadata = (struct qbuf_metadata *)q->ptr;
+    expired = metadata->next_inflight;
+    sent = metadata->sent;
+    cptr = metadata->cptr;
+    /* The upper layer expects its own packet in the callback */
+    queuebuf_to_packetbuf(q->buf);
+#if PACKETBUF_WITH_PACKET_COST
+    set_cost_attrs(q);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+    queuebuf_free(q->buf);
+    memb_free(&metadata_memb, q->ptr);
+    memb_free(&packet_memb, q);
+    mac_call_sent_callback(sent, cptr, MAC_TX_ERR,
+                           q == head ? head_transmissions : 0);
+  }
+  return alive;
+}
+/*---------------------------------------------------------------------------*/
+static void schedule_transmission(struct mac_queue_neighbor *n) {
+  clock_time_t delay;
+
+  delay = policy->backoff(n);
+
+  PRINTF("%s: scheduling transmission in %u ticks, NB=%u, BE=%u\n",
+         policy->name, (unsigned)delay, n->collisions, n->backoff_exponent);
+  MAC_TRACE(MAC_TRACE_BACKOFF, n->backoff_exponent,
+            delay > 0xffff ? 0xffff : delay);
+  ctimer_set(&n->transmit_timer, delay, transmit_packet_list, n);
+}
+/*---------------------------------------------------------------------------*/
+static void transmit_packet_list(void *ptr) {
+  struct mac_queue_neighbor *n = ptr;
+  if (n) {
+    struct rdc_buf_list *q;
+    if (!drop_expired(n)) {
+      return;
+    }
+    q = list_head(n->queued_packet_list);
+    if (q != NULL) {
+      PRINTF("%s: preparing number %d %p, queue len %d\n", policy->name,
+             n->transmissions, q, list_length(n->queued_packet_list));
+      switch (policy->access != NULL ? policy->access(n) : MAC_TX_OK) {
+        case MAC_TX_OK:
+          /* Send packets in the neighbor's list */
+#if PACKETBUF_WITH_PACKET_COST
+          mark_radio_time(n);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+          n->in_rdc = 1;
+          NETSTACK_RDC.send_list(packet_sent, n, q);
+          break;
+        case MAC_TX_DEFERRED:
+          schedule_transmission(n);
+          break;
+        default:
+          /* Channel busy. The packetbuf may hold anything by now, the
+             upper layer expects its own packet when it is dropped. */
+          queuebuf_to_packetbuf(q->buf);
+#if MAC_STATS_ON
+          mac_stats_tx(neighbor_stats(n), MAC_TX_COLLISION, 1, 0);
+#endif /* MAC_STATS_ON */
+          collision(q, n, 1);
+          break;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void free_packet(struct mac_queue_neighbor *n, struct rdc_buf_list *p,
+                        int status) {
+  if (p != NULL) {
+#if MAC_QUEUE_WITH_BURST
+    /* An acknowledged frame with the pending bit set means that the RDC
+       layer goes on with the next frame of the list right away */
+    uint8_t in_burst =
+        status == MAC_TX_OK && queuebuf_attr(p->buf, PACKETBUF_ATTR_PENDING);
+#endif /* MAC_QUEUE_WITH_BURST */
+
+    /* Remove packet from list and deallocate */
+    list_remove(n->queued_packet_list, p);
+    inflight_remove(p);
+
+    queuebuf_free(p->buf);
+    memb_free(&metadata_memb, p->ptr);
+    memb_free(&packet_memb, p);
+    PRINTF("%s: free_queued_packet, queue length %d, free packets %d\n",
+           policy->name, list_length(n->queued_packet_list),
+           memb_numfree(&packet_memb));
+    if (list_head(n->queued_packet_list) != NULL) {
+      /* There is a next packet. We reset current tx information */
+      n->transmissions = 0;
+      reset_backoff(n);
+#if MAC_QUEUE_WITH_BURST
+      if (in_burst) {
+        PRINTF("%s: burst continues, queue len %d\n", policy->name,
+               list_length(n->queued_packet_list));
+        ctimer_stop(&n->transmit_timer);
+        n->in_rdc = 1;
+        return;
+      }
+#endif /* MAC_QUEUE_WITH_BURST */
+      /* Schedule next transmissions */
+      schedule_transmission(n);
+    } else {
+      /* This was the last packet in the queue, we free the neighbor */
+      ctimer_stop(&n->transmit_timer);
+      neighbor_queue_remove(n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void tx_done(int status, struct rdc_buf_list *q,
+                    struct mac_queue_neighbor *n) {
+  mac_callback_t sent;
+  struct qbuf_metadata *metadata;
+  void *cptr;
+  uint8_t ntx;
+
+  metadata = (struct qbuf_metadata *)q->ptr;
+  sent = metadata->sent;
+  cptr = metadata->cptr;
+  ntx = n->transmissions;
+
+  switch (status) {
+    case MAC_TX_OK:
+      PRINTF("%s: rexmit ok %d\n", policy->name, n->transmissions);
+      break;
+    case MAC_TX_COLLISION:
+    case MAC_TX_NOACK:
+      PRINTF("%s: drop with status %d after %d transmissions, %d collisions\n",
+             policy->name, status, n->transmissions, n->collisions);
+      break;
+    default:
+      PRINTF("%s: rexmit failed %d: %d\n", policy->name, n->transmissions,
+             status);
+      break;
+  }
+
+#if MAC_STATS_ON
+  mac_stats_done(neighbor_stats(n), status, metadata->queued_at);
+#endif /* MAC_STATS_ON */
+#if PACKETBUF_WITH_PACKET_COST
+  set_cost_attrs(q);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
+  free_packet(n, q, status);
+  mac_call_sent_callback(sent, cptr, status, ntx);
+}
+/*---------------------------------------------------------------------------*/
+static void rexmit(struct rdc_buf_list *q, struct mac_queue_neighbor *n) {
+  schedule_transmission(n);
+  /* This is needed to correctly attribute energy that we spent
+     transmitting this packet. */
+  queuebuf_update_attr_from_packetbuf(q->buf);
+}
+/*---------------------------------------------------------------------------*/
+static void collision(struct rdc_buf_list *q, struct mac_queue_neighbor *n,
+                      int num_transmissions) {
+  struct qbuf_metadata *metadata;
+
+  metadata = (struct qbuf_metadata *)q->ptr;
+
+  n->collisions += num_transmissions;
+  increase_backoff(n);
+
+  if (n->collisions > policy->max_backoffs) {
+    n->collisions = 0;
+    /* Increment to indicate a next retry */
+    n->transmissions++;
+  }
+
+  if (n->transmissions >= metadata->max_transmissions) {
+    tx_done(MAC_TX_COLLISION, q, n);
+  } else {
+    PRINTF("%s: rexmit collision %d\n", policy->name, n->transmissions);
+    rexmit(q, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void noack(struct rdc_buf_list *q, struct mac_queue_neighbor *n,
+                  int num_transmissions) {
+  struct qbuf_metadata *metadata;
+
+  metadata = (struct qbuf_metadata *)q->ptr;
+
+  n->transmissions += num_transmissions;
+  if (policy->flags & MAC_QUEUE_BACKOFF_ON_NOACK) {
+    n->collisions = 0;
+    increase_backoff(n);
+  } else {
+    reset_backoff(n);
+  }
+
+  if (n->transmissions >= metadata->max_transmissions) {
+    tx_done(MAC_TX_NOACK, q, n);
+  } else {
+    PRINTF("%s: rexmit noack %d\n", policy->name, n->transmissions);
+    rexmit(q, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void tx_ok(struct rdc_buf_list *q, struct mac_queue_neighbor *n,
+                  int num_transmissions) {
+  reset_backoff(n);
+  n->transmissions += num_transmissions;
+  tx_done(MAC_TX_OK, q, n);
+}
+/*---------------------------------------------------------------------------*/
+static void packet_sent(void *ptr, int status, int num_transmissions) {
+  struct mac_queue_neighbor *n;
+  struct rdc_buf_list *q;
+
+  n = ptr;
+  if (n == NULL) {
+    return;
+  }
+
+  /* Find out what packet this callback refers to */
+  q = inflight_lookup(n, packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
+
+  if (q == NULL) {
+    PRINTF("%s: seqno %d not queued to this neighbor\n", policy->name,
+           packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO));
+    return;
+  } else if (q->ptr == NULL) {
+    PRINTF("%s: no metadata\n", policy->name);
+    return;
+  }
+
+  if (status != MAC_TX_DEFERRED) {
+    n->in_rdc = 0;
+  }
+
+#if PACKETBUF_WITH_PACKET_COST
+  account_energy(q, n);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
+#if MAC_STATS_ON
+  mac_stats_tx(neighbor_stats(n), status, num_transmissions,
+               packetbuf_totlen());
+#endif /* MAC_STATS_ON */
+
+  if (policy->tx_status != NULL && status != MAC_TX_DEFERRED) {
+    policy->tx_status(n, status);
+  }
+
+  switch (status) {
+    case MAC_TX_OK:
+      tx_ok(q, n, num_transmissions);
+      break;
+    case MAC_TX_NOACK:
+      noack(q, n, num_transmissions);
+      break;
+    case MAC_TX_COLLISION:
+      collision(q, n, num_transmissions);
+      break;
+    case MAC_TX_DEFERRED:
+      break;
+    default:
+      tx_done(status, q, n);
+      break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void mac_queue_send(mac_callback_t sent, void *ptr) {
+  struct rdc_buf_list *q;
+  struct mac_queue_neighbor *n;
+  static uint8_t initialized = 0;
+  static uint16_t seqno;
+  const linkaddr_t *addr = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+
+  if (!initialized) {
+    initialized = 1;
+    /* Initialize the sequence number to a random value as per 802.15.4. */
+    seqno = random_rand();
+  }
+
+  if (seqno == 0) {
+    /* PACKETBUF_ATTR_MAC_SEQNO cannot be zero, due to a pecuilarity
+       in framer-802154.c. */
+    seqno++;
+  }
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno++);
+
+  /* Look for the neighbor entry */
+  n = neighbor_queue_from_addr(addr);
+  if (n == NULL) {
+    /* Allocate a new neighbor entry */
+    n = memb_alloc(&neighbor_memb);
+    if (n != NULL) {
+      /* Init neighbor entry */
+      linkaddr_copy(&n->addr, addr);
+      n->transmissions = 0;
+      n->in_rdc = 0;
+      reset_backoff(n);
+#if MAC_STATS_ON
+      n->stats = mac_stats_lookup(addr);
+#endif /* MAC_STATS_ON */
+      /* Init packet list for this neighbor */
+      LIST_STRUCT_INIT(n, queued_packet_list);
+      /* Add neighbor to the index */
+      neighbor_queue_add(n);
+    }
+  }
+
+  if (n != NULL) {
+    /* Add packet to the neighbor's queue */
+    if (list_length(n->queued_packet_list) <
+        MAC_QUEUE_MAX_PACKET_PER_NEIGHBOR) {
+      q = memb_alloc(&packet_memb);
+      if (q != NULL) {
+        q->ptr = memb_alloc(&metadata_memb);
+        if (q->ptr != NULL) {
+          q->buf = queuebuf_new_from_packetbuf();
+          if (q->buf != NULL) {
+            struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
+            /* Neighbor and packet successfully allocated */
+            if (packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS) == 0) {
+              /* Use default configuration for max transmissions */
+              metadata->max_transmissions = policy->max_transmissions;
+            } else {
+              metadata->max_transmissions =
+                  packetbuf_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS);
+            }
+            metadata->sent = sent;
+            metadata->cptr = ptr;
+            metadata->owner = n;
+            metadata->seqno = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+            metadata->class = packet_class();
+            metadata->queued_at = clock_time();
+#if PACKETBUF_WITH_PACKET_COST
+            metadata->energy = 0;
+#endif /* PACKETBUF_WITH_PACKET_COST */
+            inflight_add(q);
+            enqueue(n, q);
+
+            PRINTF("%s: send_packet, queue length %d, free packets %d\n",
+                   policy->name, list_length(n->queued_packet_list),
+                   memb_numfree(&packet_memb));
+            /* If q is the only packet in the neighbor's queue, send asap.
+               A packet that overtook a backing-off head goes out when that
+               backoff expires. */
+            if (list_head(n->queued_packet_list) == q &&
+                list_item_next(q) == NULL) {
+              if (policy->flags & MAC_QUEUE_SEND_IMMEDIATELY) {
+                transmit_packet_list(n);
+              } else {
+                schedule_transmission(n);
+              }
+            }
+            return;
+          }
+          memb_free(&metadata_memb, q->ptr);
+          PRINTF("%s: could not allocate queuebuf, dropping packet\n",
+                 policy->name);
+        }
+        memb_free(&packet_memb, q);
+        PRINTF("%s: could not allocate queuebuf, dropping packet\n",
+               policy->name);
+      }
+      /* The packet allocation failed. Remove and free neighbor entry if empty.
+       */
+      if (list_length(n->queued_packet_list) == 0) {
+        neighbor_queue_remove(n);
+      }
+    } else {
+      PRINTF("%s: Neighbor queue full\n", policy->name);
+    }
+    PRINTF("%s: could not allocate packet, dropping packet\n", policy->name);
+  } else {
+    PRINTF("%s: could not allocate neighbor, dropping packet\n", policy->name);
+  }
+#if MAC_STATS_ON
+  mac_stats_lookup(addr)->drops++;
+#endif /* MAC_STATS_ON */
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
+}
+/*---------------------------------------------------------------------------*/
+void mac_queue_input(void) { NETSTACK_LLSEC.input(); }
+/*---------------------------------------------------------------------------*/
+int mac_queue_on(void) { return NETSTACK_RDC.on(); }
+/*---------------------------------------------------------------------------*/
+int mac_queue_off(int keep_radio_on) {
+  return NETSTACK_RDC.off(keep_radio_on);
+}
+/*---------------------------------------------------------------------------*/
+unsigned short mac_queue_channel_check_interval(void) {
+  if (NETSTACK_RDC.channel_check_interval) {
+    return NETSTACK_RDC.channel_check_interval();
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void mac_queue_init(const struct mac_queue_policy *p) {
+  policy = p;
+  memb_init(&packet_memb);
+  memb_init(&metadata_memb);
+  memb_init(&neighbor_memb);
+#if MAC_STATS_ON
+  mac_stats_init();
+#endif /* MAC_STATS_ON */
+  mac_trace_init();
+  if (policy->init != NULL) {
+    policy->init();
+  }
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Per-neighbor packet queues and retransmissions shared by the
+ *         CSMA and ALOHA MAC layers. When and how a queued packet gets
+ *         on the channel is decided by a struct mac_queue_policy.
+ */
+
+#ifndef MAC_QUEUE_H_
+#define MAC_QUEUE_H_
+
+#include "lib/list.h"
+#include "net/linkaddr.h"
+#include "net/mac/mac.h"
+#include "net/mac/mac-stats.h"
+#include "net/packetbuf.h"
+#include "sys/clock.h"
+#include "sys/ctimer.h"
+
+/* Every neighbor has its own packet queue */
+struct mac_queue_neighbor {
+  /* Next neighbor in the same hash bucket */
+  struct mac_queue_neighbor *next;
+  linkaddr_t addr;
+  struct ctimer transmit_timer;
+  /* Transmissions of the packet at the head of the queue */
+  uint8_t transmissions;
+  /* Collisions since the last counted transmission */
+  uint8_t collisions;
+  /* Backoff exponent, between min_be and max_be of the policy */
+  uint8_t backoff_exponent;
+  /* Set while the head of the queue is with the RDC layer */
+  uint8_t in_rdc;
+#if MAC_STATS_ON
+  struct mac_stats *stats;
+#endif /* MAC_STATS_ON */
+#if PACKETBUF_WITH_PACKET_COST
+  /* Energest radio times when the queue was handed to the RDC layer, or
+     when the RDC layer last reported on it */
+  unsigned long listen_mark;
+  unsigned long transmit_mark;
+#endif /* PACKETBUF_WITH_PACKET_COST */
+  LIST_STRUCT(queued_packet_list);
+};
+
+/* Flags of struct mac_queue_policy */
+
+/* Hand the first packet of an idle queue to the RDC layer at once,
+   instead of backing off first */
+#define MAC_QUEUE_SEND_IMMEDIATELY 0x01
+/* A missing ACK increases the backoff exponent like a collision does,
+   instead of resetting it to min_be */
+#define MAC_QUEUE_BACKOFF_ON_NOACK 0x02
+
+/**
+ * A channel access policy. The queue engine owns the packets and the
+ * retry bookkeeping, the policy only decides how long to back off and
+ * whether the channel may be used right now.
+ */
+struct mac_queue_policy {
+  char *name;
+
+  /** Initialize the policy, called from mac_queue_init(). May be NULL. */
+  void (* init)(void);
+
+  /** Delay, in clock ticks, before the next transmission attempt to n. */
+  clock_time_t (* backoff)(const struct mac_queue_neighbor *n);
+
+  /**
+   * Called when the backoff for n has expired, right before its queue is
+   * handed to the RDC layer. Returns MAC_TX_OK to transmit,
+   * MAC_TX_DEFERRED to back off again without penalty, or
+   * MAC_TX_COLLISION when the channel was found busy. May be NULL.
+   */
+  int (* access)(struct mac_queue_neighbor *n);
+
+  /** Outcome of every transmission reported by the RDC layer. May be
+      NULL. */
+  void (* tx_status)(const struct mac_queue_neighbor *n, int status);
+
+  /* macMinBE and macMaxBE */
+  uint8_t min_be;
+  uint8_t max_be;
+  /* Collisions that count as one transmission (macMaxCSMABackoffs) */
+  uint8_t max_backoffs;
+  /* Transmissions per packet, unless PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS
+     is set */
+  uint8_t max_transmissions;
+  /* MAC_QUEUE_* flags */
+  uint8_t flags;
+};
+
+/**
+ * \brief      Initialize the queues and select the access policy
+ * \param policy The channel access policy used for all neighbors
+ */
+void mac_queue_init(const struct mac_queue_policy *policy);
+
+/**
+ * \brief      Queue the packet in the packetbuf for its receiver
+ *
+ *             Has the signature of mac_driver.send.
+ */
+void mac_queue_send(mac_callback_t sent, void *ptr);
+
+/* The remaining mac_driver functions, common to all policies */
+void mac_queue_input(void);
+int mac_queue_on(void);
+int mac_queue_off(int keep_radio_on);
+unsigned short mac_queue_channel_check_interval(void);
+
+#endif /* MAC_QUEUE_H_ */
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Per-neighbor MAC layer statistics
+ */
+
+#include "net/mac/mac-stats.h"
+#include "net/mac/mac.h"
+
+#include <string.h>
+
+/* IEEE 802.15.4 2.4 GHz: 32 usec per byte, plus preamble, SFD and
+   length bytes. Strobing RDC layers such as ContikiMAC repeat a frame
+   several times per reported transmission, the estimate then only
+   covers the first copy. */
+#define BYTE_AIRTIME_US 32
+#define PHY_OVERHEAD    6
+
+static struct mac_stats table[MAC_STATS_NUM_NEIGHBORS];
+static uint8_t used;
+
+/*---------------------------------------------------------------------------*/
+static void
+clear_counters(struct mac_stats *s)
+{
+  s->attempts = 0;
+  s->successes = 0;
+  s->collisions = 0;
+  s->noacks = 0;
+  s->drops = 0;
+  memset(s->delay, 0, sizeof(s->delay));
+  s->airtime = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_stats_init(void)
+{
+  memset(table, 0, sizeof(table));
+  used = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Neighbor queues keep pointers into the table, so the entries stay
+   allocated to their addresses and only the counters start over */
+void
+mac_stats_reset(void)
+{
+  int i;
+
+  for(i = 0; i < used; i++) {
+    clear_counters(&table[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct mac_stats *
+mac_stats_lookup(const linkaddr_t *addr)
+{
+  struct mac_stats *s;
+  struct mac_stats *oldest;
+  int i;
+
+  oldest = &table[0];
+  for(i = 0; i < used; i++) {
+    s = &table[i];
+    if(linkaddr_cmp(&s->addr, addr)) {
+      s->last_used = clock_time();
+      return s;
+    }
+    if((clock_time_t)(clock_time() - s->last_used) >
+       (clock_time_t)(clock_time() - oldest->last_used)) {
+      oldest = s;
+    }
+  }
+
+  if(used < MAC_STATS_NUM_NEIGHBORS) {
+    s = &table[used++];
+  } else {
+    s = oldest;
+  }
+  memset(s, 0, sizeof(*s));
+  linkaddr_copy(&s->addr, addr);
+  s->last_used = clock_time();
+  return s;
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_stats_tx(struct mac_stats *s, int status, int num_tx, uint16_t len)
+{
+  switch(status) {
+  case MAC_TX_COLLISION:
+    /* The frame did not go out */
+    s->collisions += num_tx;
+    return;
+  case MAC_TX_OK:
+    s->successes++;
+    break;
+  case MAC_TX_NOACK:
+    s->noacks += num_tx;
+    break;
+  case MAC_TX_DEFERRED:
+    return;
+  default:
+    break;
+  }
+  s->attempts += num_tx;
+  s->airtime += (uint32_t)num_tx * (len + PHY_OVERHEAD) * BYTE_AIRTIME_US;
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_stats_done(struct mac_stats *s, int status, clock_time_t queued_at)
+{
+  clock_time_t units;
+  uint8_t bucket;
+
+  if(status != MAC_TX_OK) {
+    s->drops++;
+  }
+
+  units = (clock_time() - queued_at) / MAC_STATS_DELAY_UNIT;
+  bucket = 0;
+  while(units > 0 && bucket < MAC_STATS_DELAY_BUCKETS - 1) {
+    units >>= 1;
+    bucket++;
+  }
+  s->delay[bucket]++;
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_stats *
+mac_stats_get(int i)
+{
+  if(i < 0 || i >= used) {
+    return NULL;
+  }
+  return &table[i];
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+put16(uint8_t *p, uint16_t v)
+{
+  p[0] = v & 0xff;
+  p[1] = v >> 8;
+  return p + 2;
+}
+/*---------------------------------------------------------------------------*/
+int
+mac_stats_dump(uint8_t *buf, int len)
+{
+  const int entry_len = LINKADDR_SIZE + 2 * (5 + MAC_STATS_DELAY_BUCKETS) + 4;
+  struct mac_stats *s;
+  uint8_t *p;
+  int i, j;
+
+  if(len < 4) {
+    return 0;
+  }
+
+  p = buf + 4;
+  for(i = 0; i < used && (p - buf) + entry_len <= len; i++) {
+    s = &table[i];
+    memcpy(p, s->addr.u8, LINKADDR_SIZE);
+    p += LINKADDR_SIZE;
+    p = put16(p, s->attempts);
+    p = put16(p, s->successes);
+    p = put16(p, s->collisions);
+    p = put16(p, s->noacks);
+    p = put16(p, s->drops);
+    for(j = 0; j < MAC_STATS_DELAY_BUCKETS; j++) {
+      p = put16(p, s->delay[j]);
+    }
+    p = put16(p, s->airtime & 0xffff);
+    p = put16(p, s->airtime >> 16);
+  }
+
+  buf[0] = MAC_STATS_DUMP_VERSION;
+  buf[1] = i;
+  buf[2] = LINKADDR_SIZE;
+  buf[3] = MAC_STATS_DELAY_BUCKETS;
+  return p - buf;
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Per-neighbor MAC layer statistics
+ */
+
+#ifndef MAC_STATS_H
+#define MAC_STATS_H
+
+#include "contiki-conf.h"
+#include "net/linkaddr.h"
+#include "sys/cc.h"
+#include "sys/clock.h"
+
+/* MAC_STATS_ON keeps per-neighbor counters in the MAC queue (csma and
+   aloha drivers). Off by default, it costs about 40 bytes of RAM per
+   entry. */
+#ifdef MAC_STATS_CONF_ON
+#define MAC_STATS_ON MAC_STATS_CONF_ON
+#else
+#define MAC_STATS_ON 0
+#endif
+
+/* Number of neighbors tracked. When the table is full, the entry used
+   least recently is recycled. */
+#ifdef MAC_STATS_CONF_NUM_NEIGHBORS
+#define MAC_STATS_NUM_NEIGHBORS MAC_STATS_CONF_NUM_NEIGHBORS
+#else
+#define MAC_STATS_NUM_NEIGHBORS 8
+#endif
+
+/* Buckets of the queueing delay histogram. Bucket 0 counts delays below
+   one MAC_STATS_DELAY_UNIT, bucket i delays below 2^i units, the last
+   bucket everything above. */
+#define MAC_STATS_DELAY_BUCKETS 8
+
+/* Resolution of the delay histogram, in clock ticks */
+#ifdef MAC_STATS_CONF_DELAY_UNIT
+#define MAC_STATS_DELAY_UNIT MAC_STATS_CONF_DELAY_UNIT
+#else
+#define MAC_STATS_DELAY_UNIT MAX(CLOCK_SECOND / 128, 1)
+#endif
+
+/* Version of the mac_stats_dump() format */
+#define MAC_STATS_DUMP_VERSION 1
+
+struct mac_stats {
+  linkaddr_t addr;
+  /* Frames handed to the radio, including retransmissions */
+  uint16_t attempts;
+  /* Packets acknowledged, or sent if broadcast */
+  uint16_t successes;
+  /* Transmissions given up because the channel was busy */
+  uint16_t collisions;
+  /* Transmissions that were not acknowledged */
+  uint16_t noacks;
+  /* Packets that were never queued or given up after the last retry */
+  uint16_t drops;
+  /* Time from queueing to the final outcome of a packet */
+  uint16_t delay[MAC_STATS_DELAY_BUCKETS];
+  /* Estimated time on air, in microseconds */
+  uint32_t airtime;
+  /* For recycling, not part of the dump */
+  clock_time_t last_used;
+};
+
+void mac_stats_init(void);
+void mac_stats_reset(void);
+
+/**
+ * \brief      Find the entry of a neighbor, allocating one if needed
+ * \param addr Link-layer address, linkaddr_null for broadcast
+ * \return     The entry, never NULL
+ */
+struct mac_stats *mac_stats_lookup(const linkaddr_t *addr);
+
+/**
+ * \brief      Account for a transmission outcome reported by the RDC
+ * \param s    The neighbor entry
+ * \param status The MAC_TX_ status
+ * \param num_tx The number of transmissions reported with it
+ * \param len  Frame length in bytes, for the airtime estimate
+ */
+void mac_stats_tx(struct mac_stats *s, int status, int num_tx, uint16_t len);
+
+/**
+ * \brief      Account for the final outcome of a packet
+ * \param s    The neighbor entry
+ * \param status The status reported to the upper layer
+ * \param queued_at The clock_time() when the packet was queued
+ */
+void mac_stats_done(struct mac_stats *s, int status, clock_time_t queued_at);
+
+/** Entry i of the table, or NULL if unused */
+const struct mac_stats *mac_stats_get(int i);
+
+/**
+ * \brief      Serialize the table in a compact binary format
+ * \param buf  Output buffer
+ * \param len  Size of buf
+ * \return     Number of bytes written
+ *
+ *             The format is a 4-byte header (version, number of entries,
+ *             address size, delay buckets), followed by each entry: the
+ *             address, the five counters and the delay histogram as
+ *             16-bit values, and the airtime as a 32-bit value, all
+ *             little-endian. Entries that do not fit in buf are left
+ *             out and not counted in the header.
+ */
+int mac_stats_dump(uint8_t *buf, int len);
+
+#endif /* MAC_STATS_H */
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Binary trace of MAC and RDC events
+ */
+
+#include "contiki.h"
+#include "net/linkaddr.h"
+#include "net/mac/mac-trace.h"
+
+#include <stdio.h>
+
+#if MAC_TRACE_ON
+
+#if (MAC_TRACE_LEN & (MAC_TRACE_LEN - 1)) != 0
+#error MAC_TRACE_LEN must be power of two
+#endif
+
+/* Records printed per line */
+#define RECORDS_PER_LINE 8
+
+/* Not static, so that a debugger or Cooja can read the buffer directly.
+   Records between tail and head are pending. head and tail are free
+   running, the slot of a record is its index modulo MAC_TRACE_LEN. */
+struct mac_trace_record mac_trace_buf[MAC_TRACE_LEN];
+volatile uint16_t mac_trace_head;
+volatile uint16_t mac_trace_tail;
+volatile uint16_t mac_trace_dropped;
+
+PROCESS(mac_trace_process, "MAC trace");
+
+/*---------------------------------------------------------------------------*/
+/* Nonzero if nobody has filled the record yet */
+static int
+record_free(volatile struct mac_trace_record *r)
+{
+  return r->event == MAC_TRACE_NONE;
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_trace_add(uint8_t event, uint8_t arg, uint16_t value)
+{
+  /* Volatile, an interrupt may fill the record between two reads, and
+     the event must be stored after the other fields */
+  volatile struct mac_trace_record *r;
+  uint16_t head;
+
+  /* Called from processes and interrupts alike, without a lock. An
+     interrupt runs to completion, so a caller interrupted while
+     claiming a slot finds that slot filled afterwards and moves on to
+     the next one. Slots are claimed before they are filled, the event
+     is written last and marks the record as complete for the drain. */
+  head = mac_trace_head;
+  for(;;) {
+    if((uint16_t)(head - mac_trace_tail) >= MAC_TRACE_LEN) {
+      mac_trace_dropped++;
+      return;
+    }
+    r = &mac_trace_buf[head & (MAC_TRACE_LEN - 1)];
+    if(record_free(r)) {
+      mac_trace_head = head + 1;
+      if(record_free(r)) {
+        break;
+      }
+    }
+    head++;
+  }
+  r->time = RTIMER_NOW();
+  r->arg = arg;
+  r->value = value;
+  r->event = event;
+
+  if((uint16_t)(head - mac_trace_tail) == MAC_TRACE_LEN / 2) {
+    process_poll(&mac_trace_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_trace_drain(void)
+{
+  struct mac_trace_record *r;
+  uint16_t tail;
+  int n;
+
+  tail = mac_trace_tail;
+  n = 0;
+  while(tail != mac_trace_head) {
+    r = &mac_trace_buf[tail & (MAC_TRACE_LEN - 1)];
+    if(r->event == MAC_TRACE_NONE) {
+      /* Claimed but not filled yet */
+      break;
+    }
+    if(n == 0) {
+      printf("#MT %u.%u %u %u ",
+             linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
+             tail, mac_trace_dropped);
+    }
+    printf("%08lx%02x%02x%04x", (unsigned long)r->time,
+           r->event, r->arg, r->value);
+    r->event = MAC_TRACE_NONE;
+    tail++;
+    mac_trace_tail = tail;
+    if(++n == RECORDS_PER_LINE) {
+      printf("\n");
+      n = 0;
+    }
+  }
+  if(n > 0) {
+    printf("\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mac_trace_process, ev, data)
+{
+  static struct etimer periodic;
+
+  PROCESS_BEGIN();
+
+  etimer_set(&periodic, MAC_TRACE_DRAIN_INTERVAL);
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL || etimer_expired(&periodic));
+    if(etimer_expired(&periodic)) {
+      etimer_reset(&periodic);
+    }
+    mac_trace_drain();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+mac_trace_init(void)
+{
+  /* Does nothing if the process already runs */
+  process_start(&mac_trace_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+
+#endif /* MAC_TRACE_ON */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Binary trace of MAC and RDC events
+ *
+ *         Events are stored as fixed-size records in a ring buffer,
+ *         which takes a few instructions and is safe in rtimer and
+ *         interrupt context. The buffer is drained later, from a
+ *         process, as lines of hex over serial:
+ *
+ *           #MT <node> <index> <dropped> <record><record>...
+ *
+ *         where index is the sequence number of the first record, modulo
+ *         2^16, dropped the number of records lost so far because the
+ *         buffer was full, and each record 16 hex digits: the 32-bit
+ *         rtimer time, the event, the 8-bit argument and the 16-bit
+ *         value. tools/mac-trace/decode-mac-trace turns such lines,
+ *         from a serial dump or a Cooja log, into a timeline.
+ */
+
+#ifndef MAC_TRACE_H_
+#define MAC_TRACE_H_
+
+#include "contiki-conf.h"
+
+/* MAC_TRACE_ON enables the tracer. Off by default, the MAC_TRACE()
+   calls then compile to nothing. */
+#ifdef MAC_TRACE_CONF_ON
+#define MAC_TRACE_ON MAC_TRACE_CONF_ON
+#else
+#define MAC_TRACE_ON 0
+#endif
+
+/* Number of records in the buffer, a power of two. A record takes 8
+   bytes. */
+#ifdef MAC_TRACE_CONF_LEN
+#define MAC_TRACE_LEN MAC_TRACE_CONF_LEN
+#else
+#define MAC_TRACE_LEN 64
+#endif
+
+/* Interval, in clock ticks, at which the buffer is drained. It is also
+   drained as soon as it is half full. */
+#ifdef MAC_TRACE_CONF_DRAIN_INTERVAL
+#define MAC_TRACE_DRAIN_INTERVAL MAC_TRACE_CONF_DRAIN_INTERVAL
+#else
+#define MAC_TRACE_DRAIN_INTERVAL CLOCK_SECOND
+#endif
+
+/* Events. The meaning of the argument and of the value is given for
+   each, - when unused. */
+enum {
+  MAC_TRACE_NONE,
+  /* Start of a powercycle. -, - */
+  MAC_TRACE_WAKE,
+  /* Channel check. 1 if the channel was busy, number of checks */
+  MAC_TRACE_CCA,
+  /* Start of a transmission. MAC sequence number, receiver or 0 for
+     broadcast */
+  MAC_TRACE_STROBE_START,
+  /* End of a transmission. MAC_TX_ status, number of frames sent */
+  MAC_TRACE_STROBE_END,
+  /* ACK received. MAC sequence number, - */
+  MAC_TRACE_ACK,
+  /* Frame received. MAC sequence number, sender */
+  MAC_TRACE_RX,
+  /* Radio turned off at the end of a powercycle. -, - */
+  MAC_TRACE_SLEEP,
+  /* Backoff scheduled. Backoff exponent, delay in clock ticks */
+  MAC_TRACE_BACKOFF,
+  /* First event number free for applications */
+  MAC_TRACE_USER = 128
+};
+
+/* Traced node addresses are reduced to their last two bytes */
+#define MAC_TRACE_ADDR(addr) \
+  (((uint16_t)(addr)->u8[LINKADDR_SIZE - 2] << 8) | \
+   (addr)->u8[LINKADDR_SIZE - 1])
+
+#if MAC_TRACE_ON
+
+struct mac_trace_record {
+  uint32_t time;
+  uint8_t event;
+  uint8_t arg;
+  uint16_t value;
+};
+
+void mac_trace_init(void);
+
+/**
+ * \brief      Record an event
+ * \param event A MAC_TRACE_* event
+ * \param arg  An 8-bit argument
+ * \param value A 16-bit value
+ *
+ *             The record is dropped, and counted, if the buffer is
+ *             full. Safe in interrupt context.
+ */
+void mac_trace_add(uint8_t event, uint8_t arg, uint16_t value);
+
+/**
+ * \brief      Print all pending records now
+ */
+void mac_trace_drain(void);
+
+#define MAC_TRACE(event, arg, value) mac_trace_add(event, arg, value)
+
+#else /* MAC_TRACE_ON */
+
+#define mac_trace_init()
+#define mac_trace_drain()
+#define MAC_TRACE(event, arg, value)
+
+#endif /* MAC_TRACE_ON */
+
+#endif /* MAC_TRACE_H_ */
@@ -55,6 +55,10 @@
 #define RDC_WITH_DUPLICATE_DETECTION !LLSEC802154_ENABLED
 #endif /* RDC_CONF_WITH_DUPLICATE_DETECTION */
 
+/* Duty cycles exchanged with the RDC layer are expressed in
+   1/RDC_DUTY_CYCLE_SCALE of the time, i.e. in hundredths of a percent. */
+#define RDC_DUTY_CYCLE_SCALE 10000
+
 /* List of packets to be sent by RDC layer */
 struct rdc_buf_list {
   struct rdc_buf_list *next;
@@ -88,6 +92,15 @@ struct rdc_driver {
 
   /** Returns the channel check interval, expressed in clock_time_t ticks. */
   unsigned short (* channel_check_interval)(void);
+
+  /** Change the radio duty cycle at runtime, in RDC_DUTY_CYCLE_SCALE
+      units. Optional, NULL if the driver does not support it. Returns
+      non-zero if the duty cycle was accepted. */
+  int (* set_duty_cycle)(uint16_t duty_cycle);
+
+  /** Returns the radio duty cycle currently applied, in
+      RDC_DUTY_CYCLE_SCALE units. Optional, may be NULL. */
+  uint16_t (* get_duty_cycle)(void);
 };
 
 #endif /* RDC_H_ */
@@ -72,6 +72,16 @@
 #define PACKETBUF_WITH_PACKET_TYPE NETSTACK_CONF_WITH_RIME
 #endif
 
+/* Energy and latency tags. The MAC layer reports the energy and time it
+   spent on every packet it sends, and Rime collect adds them up along
+   the path to the sink. Off by default, it adds two local and two
+   end-to-end attributes to every packet. */
+#ifdef PACKETBUF_CONF_WITH_PACKET_COST
+#define PACKETBUF_WITH_PACKET_COST PACKETBUF_CONF_WITH_PACKET_COST
+#else
+#define PACKETBUF_WITH_PACKET_COST 0
+#endif
+
 /**
  * \brief      Clear and reset the packetbuf
  *
@@ -228,6 +238,12 @@ struct packetbuf_addr {
 #define PACKETBUF_ATTR_PACKET_TYPE_STREAM_END 3
 #define PACKETBUF_ATTR_PACKET_TYPE_TIMESTAMP 4
 
+/* Traffic classes of PACKETBUF_ATTR_MAC_PRIORITY. Packets of a higher
+   class overtake queued packets of a lower one in the MAC queue. */
+#define PACKETBUF_ATTR_MAC_PRIORITY_NORMAL   0
+#define PACKETBUF_ATTR_MAC_PRIORITY_HIGH     1
+#define PACKETBUF_ATTR_MAC_PRIORITY_LOW      2
+
 enum {
   PACKETBUF_ATTR_NONE,
 
@@ -244,6 +260,13 @@ enum {
   PACKETBUF_ATTR_MAC_SEQNO,
   PACKETBUF_ATTR_MAC_ACK,
   PACKETBUF_ATTR_IS_CREATED_AND_SECURED,
+  PACKETBUF_ATTR_MAC_PRIORITY,
+#if PACKETBUF_WITH_PACKET_COST
+  /* Radio energy in microjoules and time since queueing in milliseconds
+     that the MAC layer spent on a packet, over all its transmissions */
+  PACKETBUF_ATTR_MAC_ENERGY,
+  PACKETBUF_ATTR_MAC_LATENCY,
+#endif /* PACKETBUF_WITH_PACKET_COST */
 #if TSCH_WITH_LINK_SELECTOR
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
@@ -282,6 +305,11 @@ enum {
   PACKETBUF_ATTR_EPACKET_ID,
   PACKETBUF_ATTR_EPACKET_TYPE,
   PACKETBUF_ATTR_ERELIABLE,
+#if PACKETBUF_WITH_PACKET_COST
+  /* Sums of the MAC energy and latency of all hops so far, same units */
+  PACKETBUF_ATTR_PATH_ENERGY,
+  PACKETBUF_ATTR_PATH_LATENCY,
+#endif /* PACKETBUF_WITH_PACKET_COST */
 #endif /* NETSTACK_CONF_WITH_RIME */
 
   /* These must be last */
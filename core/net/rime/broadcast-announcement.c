@@ -116,6 +116,9 @@ send_adv(void *ptr)
 
   if(adata->num > 0) {
     /* Send the packet only if it contains more than zero announcements. */
+    /* Routing beacons go ahead of queued data */
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_PRIORITY,
+                       PACKETBUF_ATTR_MAC_PRIORITY_HIGH);
     broadcast_send(&c.c);
   }
   PRINTF("%d.%d: sending neighbor advertisement with val %d\n",
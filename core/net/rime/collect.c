@@ -52,6 +52,10 @@
 
 #include "dev/radio-sensor.h"
 
+#if PACKETBUF_WITH_PACKET_COST
+#include "sys/energy-model.h"
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
 #include "lib/random.h"
 
 #include <string.h>
@@ -558,6 +562,82 @@ proactive_probing_callback(void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PACKETBUF_WITH_PACKET_COST
+static packetbuf_attr_t
+add_cost(packetbuf_attr_t cost, uint32_t more)
+{
+  return cost + more > 0xffff ? 0xffff : cost + more;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Add the cost of receiving the packet in the packetbuf, as reported
+ * by the RDC layer in the listen and transmit time attributes, to its
+ * path cost.
+ */
+static void
+add_rx_cost(void)
+{
+  uint64_t energy;
+
+  energy = energy_model_energy(ENERGEST_TYPE_LISTEN,
+                               packetbuf_attr(PACKETBUF_ATTR_LISTEN_TIME)) +
+    energy_model_energy(ENERGEST_TYPE_TRANSMIT,
+                        packetbuf_attr(PACKETBUF_ATTR_TRANSMIT_TIME));
+  packetbuf_set_attr(PACKETBUF_ATTR_PATH_ENERGY,
+                     add_cost(packetbuf_attr(PACKETBUF_ATTR_PATH_ENERGY),
+                              energy / 1000));
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Add the cost of this hop to the path cost of the queued packet i,
+ * which is in the packetbuf. The header is built when the packet is
+ * handed to the MAC layer, before the transmission it describes, so
+ * the cost of that last transmission is estimated from the earlier
+ * ones to the parent. Earlier attempts to send this packet, and the
+ * time it spent in the send queue, are accounted exactly.
+ */
+static void
+add_tx_cost(struct collect_conn *c, struct packetqueue_item *i)
+{
+  clock_time_t age = 0;
+
+  /* Packets without retransmissions have no lifetime timer */
+  if(packetbuf_attr(PACKETBUF_ATTR_MAX_REXMIT) > 0) {
+    age = clock_time() - etimer_start_time(&i->lifetimer.etimer);
+  }
+  packetbuf_set_attr(PACKETBUF_ATTR_PATH_ENERGY,
+                     add_cost(packetbuf_attr(PACKETBUF_ATTR_PATH_ENERGY),
+                              (uint32_t)c->tx_energy + c->avg_tx_energy));
+  packetbuf_set_attr(PACKETBUF_ATTR_PATH_LATENCY,
+                     add_cost(packetbuf_attr(PACKETBUF_ATTR_PATH_LATENCY),
+                              (uint32_t)age * 1000 / CLOCK_SECOND +
+                              c->avg_tx_latency));
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Account for a MAC transmission of the current packet, with the cost
+ * reported by the MAC layer in the packetbuf.
+ */
+static void
+update_tx_cost(struct collect_conn *c, int status)
+{
+  packetbuf_attr_t energy = packetbuf_attr(PACKETBUF_ATTR_MAC_ENERGY);
+  packetbuf_attr_t latency = packetbuf_attr(PACKETBUF_ATTR_MAC_LATENCY);
+
+  c->tx_energy = add_cost(c->tx_energy, energy);
+  if(status == MAC_TX_OK) {
+    if(c->avg_tx_energy == 0 && c->avg_tx_latency == 0) {
+      c->avg_tx_energy = energy;
+      c->avg_tx_latency = latency;
+    } else {
+      /* Exponentially weighted moving average, alpha = 1/4 */
+      c->avg_tx_energy = ((uint32_t)c->avg_tx_energy * 3 + energy) / 4;
+      c->avg_tx_latency = ((uint32_t)c->avg_tx_latency * 3 + latency) / 4;
+    }
+  }
+}
+#endif /* PACKETBUF_WITH_PACKET_COST */
+/*---------------------------------------------------------------------------*/
 /**
  * This function is called when a queued packet should be sent
  * out. The function takes the first packet on the output queue, adds
@@ -622,6 +702,9 @@ send_queued_packet(struct collect_conn *c)
       /* This is the first time we transmit this packet, so set
          transmissions to zero. */
       c->transmissions = 0;
+#if PACKETBUF_WITH_PACKET_COST
+      c->tx_energy = 0;
+#endif /* PACKETBUF_WITH_PACKET_COST */
 
       /* Remember that maximum amount of retransmissions we should
          make. This is stored inside a packet attribute in the packet
@@ -647,6 +730,10 @@ send_queued_packet(struct collect_conn *c)
       hdr.rtmetric = c->rtmetric;
       memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
 
+#if PACKETBUF_WITH_PACKET_COST
+      add_tx_cost(c, i);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
       /* Send the packet. */
       send_packet(c, n);
 
@@ -748,6 +835,10 @@ retransmit_current_packet(struct collect_conn *c)
       hdr.rtmetric = c->rtmetric;
       memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
 
+#if PACKETBUF_WITH_PACKET_COST
+      add_tx_cost(c, i);
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
       /* Send the packet. */
       send_packet(c, n);
     }
@@ -991,6 +1082,10 @@ node_packet_received(struct unicast_conn *c, const linkaddr_t *from)
       }
     }
 
+#if PACKETBUF_WITH_PACKET_COST
+    add_rx_cost();
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
     /* If we are the sink, the packet has reached its final
        destination and we call the receive function. */
     if(tc->rtmetric == RTMETRIC_SINK) {
@@ -1137,6 +1232,9 @@ node_packet_sent(struct unicast_conn *c, int status, int transmissions)
      PACKETBUF_ATTR_PACKET_TYPE_DATA) {
 
     tc->transmissions += transmissions;
+#if PACKETBUF_WITH_PACKET_COST
+    update_tx_cost(tc, status);
+#endif /* PACKETBUF_WITH_PACKET_COST */
     PRINTF("tx %d\n", tc->transmissions);    
     PRINTF("%d.%d: MAC sent %d transmissions to %d.%d, status %d, total transmissions %d\n",
            linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
@@ -1306,6 +1404,9 @@ collect_open(struct collect_conn *tc, uint16_t channels,
   tc->is_router = is_router;
   tc->seqno = 10;
   tc->eseqno = 0;
+#if PACKETBUF_WITH_PACKET_COST
+  tc->tx_energy = tc->avg_tx_energy = tc->avg_tx_latency = 0;
+#endif /* PACKETBUF_WITH_PACKET_COST */
   LIST_STRUCT_INIT(tc, send_queue_list);
   collect_neighbor_list_new(&tc->neighbor_list);
   tc->send_queue.list = &(tc->send_queue_list);
@@ -1443,6 +1544,10 @@ collect_send(struct collect_conn *tc, int rexmits)
   packetbuf_set_addr(PACKETBUF_ADDR_ESENDER, &linkaddr_node_addr);
   packetbuf_set_attr(PACKETBUF_ATTR_HOPS, 1);
   packetbuf_set_attr(PACKETBUF_ATTR_TTL, MAX_HOPLIM);
+#if PACKETBUF_WITH_PACKET_COST
+  packetbuf_set_attr(PACKETBUF_ATTR_PATH_ENERGY, 0);
+  packetbuf_set_attr(PACKETBUF_ATTR_PATH_LATENCY, 0);
+#endif /* PACKETBUF_WITH_PACKET_COST */
   if(rexmits > MAX_REXMITS) {
     packetbuf_set_attr(PACKETBUF_ATTR_MAX_REXMIT, MAX_REXMITS);
   } else {
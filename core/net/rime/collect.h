@@ -91,6 +91,18 @@
 #define COLLECT_MAX_REXMIT_BITS 5
 #endif /* COLLECT_CONF_REXMIT_BITS */
 
+/* With PACKETBUF_WITH_PACKET_COST, data packets carry the radio energy
+   (in microjoules) and the time (in milliseconds) spent on them by all
+   hops so far. The sink can read them with
+   packetbuf_attr(PACKETBUF_ATTR_PATH_ENERGY) and
+   packetbuf_attr(PACKETBUF_ATTR_PATH_LATENCY) in its recv callback. */
+#if PACKETBUF_WITH_PACKET_COST
+#define COLLECT_COST_ATTRIBUTES { PACKETBUF_ATTR_PATH_ENERGY, PACKETBUF_ATTR_BIT * 16 }, \
+                                { PACKETBUF_ATTR_PATH_LATENCY, PACKETBUF_ATTR_BIT * 16 },
+#else /* PACKETBUF_WITH_PACKET_COST */
+#define COLLECT_COST_ATTRIBUTES
+#endif /* PACKETBUF_WITH_PACKET_COST */
+
 #define COLLECT_ATTRIBUTES  { PACKETBUF_ADDR_ESENDER,     PACKETBUF_ADDRSIZE }, \
                             { PACKETBUF_ATTR_EPACKET_ID,  PACKETBUF_ATTR_BIT * COLLECT_PACKET_ID_BITS }, \
                             { PACKETBUF_ATTR_PACKET_ID,   PACKETBUF_ATTR_BIT * COLLECT_PACKET_ID_BITS }, \
@@ -98,6 +110,7 @@
                             { PACKETBUF_ATTR_HOPS,        PACKETBUF_ATTR_BIT * COLLECT_HOPS_BITS }, \
                             { PACKETBUF_ATTR_MAX_REXMIT,  PACKETBUF_ATTR_BIT * COLLECT_MAX_REXMIT_BITS }, \
                             { PACKETBUF_ATTR_PACKET_TYPE, PACKETBUF_ATTR_BIT }, \
+                            COLLECT_COST_ATTRIBUTES \
                             UNICAST_ATTRIBUTES
 
 struct collect_callbacks {
@@ -141,6 +154,13 @@ struct collect_conn {
   uint8_t is_router;
 
   clock_time_t send_time;
+#if PACKETBUF_WITH_PACKET_COST
+  /* MAC energy spent on the current packet by earlier transmissions,
+     and running averages of the energy and latency of a successful
+     MAC transmission to the parent */
+  uint16_t tx_energy;
+  uint16_t avg_tx_energy, avg_tx_latency;
+#endif /* PACKETBUF_WITH_PACKET_COST */
 };
 
 enum {
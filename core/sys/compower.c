@@ -45,8 +45,15 @@
 #include "contiki-conf.h"
 #include "sys/energest.h"
 #include "sys/compower.h"
+#include "sys/rtimer.h"
 #include "net/packetbuf.h"
 
+/* IEEE 802.15.4 at 2.4 GHz: 32 us per byte, and 6 bytes of preamble,
+   SFD and length in front of every frame */
+#define BYTE_TIME_US 32
+#define PHY_OVERHEAD 6
+#define ACK_FRAME_LEN 5
+
 struct compower_activity compower_idle_activity;
 
 /*---------------------------------------------------------------------------*/
@@ -95,4 +102,21 @@ compower_accumulate_attrs(struct compower_activity *e)
   e->transmit += packetbuf_attr(PACKETBUF_ATTR_TRANSMIT_TIME);
 }
 /*---------------------------------------------------------------------------*/
+static uint32_t
+airtime(uint16_t len)
+{
+  return (uint64_t)(len + PHY_OVERHEAD) * BYTE_TIME_US *
+    RTIMER_ARCH_SECOND / 1000000;
+}
+/*---------------------------------------------------------------------------*/
+void
+compower_attr_rxframe(uint16_t len, int acked)
+{
+  struct compower_activity rx;
+
+  rx.listen = airtime(len);
+  rx.transmit = acked ? airtime(ACK_FRAME_LEN) : 0;
+  compower_attrconv(&rx);
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
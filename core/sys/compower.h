@@ -129,6 +129,20 @@ void compower_attrconv(struct compower_activity *a);
  */
 void compower_accumulate_attrs(struct compower_activity *a);
 
+/**
+ * \brief      Attribute the reception of a frame to the packet in the packetbuf
+ * \param len  The length of the received frame, in bytes
+ * \param acked Non-zero if the frame was acknowledged
+ *
+ *             This function adds the time on air of the frame, as
+ *             listen time, and that of its acknowledgement, as transmit
+ *             time, to the packet attributes. It is meant for MAC
+ *             protocols that cannot tell the energy spent on a
+ *             reception apart from idle listening, such as those that
+ *             keep the radio on.
+ */
+void compower_attr_rxframe(uint16_t len, int acked);
+
 #endif /* COMPOWER_H_ */
 
 /** @} */
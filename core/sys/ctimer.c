@@ -151,7 +151,6 @@ ctimer_stop(struct ctimer *c)
   if(initialized) {
     etimer_stop(&c->etimer);
   } else {
-    c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
   }
   list_remove(ctimer_list, c);
@@ -40,6 +40,8 @@
 #include "sys/energest.h"
 #include "contiki-conf.h"
 
+#include <string.h>
+
 #if ENERGEST_CONF_ON
 
 int energest_total_count;
@@ -66,8 +68,8 @@ energest_init(void)
 #endif
 }
 /*---------------------------------------------------------------------------*/
-unsigned long
-energest_type_time(int type)
+uint64_t
+energest_type_time64(int type)
 {
   /* Note: does not support ENERGEST_CONF_LEVELDEVICE_LEVELS! */
 #ifndef ENERGEST_CONF_LEVELDEVICE_LEVELS
@@ -82,6 +84,70 @@ energest_type_time(int type)
 }
 /*---------------------------------------------------------------------------*/
 unsigned long
+energest_type_time(int type)
+{
+  return (unsigned long)energest_type_time64(type);
+}
+/*---------------------------------------------------------------------------*/
+/* Nonzero if any state differs from what was read into s, start and
+   mode */
+static int
+changed(const struct energest_snapshot *s, const rtimer_clock_t *start,
+        const unsigned char *mode)
+{
+  const volatile energest_t *total = energest_total_time;
+  const volatile rtimer_clock_t *current_time = energest_current_time;
+  const volatile unsigned char *current_mode = energest_current_mode;
+  int i;
+
+  for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+    if(current_mode[i] != mode[i] || current_time[i] != start[i] ||
+       total[i].current != s->time[i]) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_snapshot(struct energest_snapshot *s)
+{
+  const volatile energest_t *total = energest_total_time;
+  const volatile rtimer_clock_t *current_time = energest_current_time;
+  const volatile unsigned char *current_mode = energest_current_mode;
+  rtimer_clock_t start[ENERGEST_TYPE_MAX];
+  unsigned char mode[ENERGEST_TYPE_MAX];
+  rtimer_clock_t now;
+  int i;
+
+  /* Interrupts may switch states, and tear the 64-bit totals, while
+     they are read. The states are read again after taking the time,
+     until nothing changed in between: they were then all valid at that
+     time. Totals only grow and start times move forward, so no change
+     goes unnoticed. */
+  do {
+    for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+      mode[i] = current_mode[i];
+      start[i] = current_time[i];
+      s->time[i] = total[i].current;
+    }
+    now = RTIMER_NOW();
+  } while(changed(s, start, mode));
+
+  for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+    if(mode[i]) {
+      s->time[i] += (rtimer_clock_t)(now - start[i]);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+energest_type_time_since(const struct energest_snapshot *s, int type)
+{
+  return energest_type_time64(type) - s->time[type];
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
 energest_leveldevice_leveltime(int powerlevel)
 {
 #ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
@@ -117,5 +183,8 @@ energest_flush(void)
 void energest_type_set(int type, unsigned long val) {}
 void energest_init(void) {}
 unsigned long energest_type_time(int type) { return 0; }
+uint64_t energest_type_time64(int type) { return 0; }
+void energest_snapshot(struct energest_snapshot *s) { memset(s, 0, sizeof(*s)); }
+uint64_t energest_type_time_since(const struct energest_snapshot *s, int type) { return 0; }
 void energest_flush(void) {}
 #endif /* ENERGEST_CONF_ON */
@@ -42,9 +42,11 @@
 
 #include "sys/rtimer.h"
 
+/* Time in each state is accumulated in rtimer ticks, in 64 bits so that
+   it does not wrap around in any experiment */
 typedef struct {
   /*  unsigned long cumulative[2];*/
-  unsigned long current;
+  uint64_t current;
 } energest_t;
 
 enum energest_type {
@@ -67,8 +69,52 @@ enum energest_type {
   ENERGEST_TYPE_MAX
 };
 
+/* Times of all states at one point in time, in rtimer ticks */
+struct energest_snapshot {
+  uint64_t time[ENERGEST_TYPE_MAX];
+};
+
 void energest_init(void);
+
+/**
+ * \brief      Time spent in a state
+ * \param type An ENERGEST_TYPE_*
+ * \return     The time in rtimer ticks, truncated to an unsigned long
+ *
+ *             The result wraps around after 36 hours with a 32 kHz
+ *             rtimer and a 32-bit unsigned long. Differences of two
+ *             results, computed as an unsigned long, are still correct
+ *             for shorter intervals.
+ */
 unsigned long energest_type_time(int type);
+
+/**
+ * \brief      Time spent in a state, in rtimer ticks
+ */
+uint64_t energest_type_time64(int type);
+
+/**
+ * \brief      Record the times of all states at once
+ * \param s    The snapshot to fill in
+ *
+ *             All times are taken at the same rtimer tick, even if
+ *             states change in interrupts meanwhile, so that they add
+ *             up to the elapsed time.
+ */
+void energest_snapshot(struct energest_snapshot *s);
+
+/**
+ * \brief      Time spent in a state since a snapshot was taken
+ * \param s    The snapshot
+ * \param type An ENERGEST_TYPE_*
+ * \return     The time in rtimer ticks
+ */
+uint64_t energest_type_time_since(const struct energest_snapshot *s, int type);
+
+/* Time spent in a state between two snapshots */
+#define energest_snapshot_diff(from, to, type) \
+  ((to)->time[type] - (from)->time[type])
+
 #ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
 unsigned long energest_leveldevice_leveltime(int powerlevel);
 #endif
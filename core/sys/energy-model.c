@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Energy accounting on top of Energest
+ */
+
+#include "sys/energy-model.h"
+#include "sys/ctimer.h"
+#include "sys/cc.h"
+
+#include <string.h>
+
+const struct energy_model_profile energy_model_sky = {
+  "sky",
+  3000,
+  {
+    /* ENERGEST_TYPE_CPU: MCU on, radio off */
+    1800000,
+    /* ENERGEST_TYPE_LPM: MCU standby */
+    5100,
+    /* ENERGEST_TYPE_IRQ: counted as CPU time already */
+    0,
+    /* ENERGEST_TYPE_LED_GREEN, YELLOW, RED: not modelled */
+    0, 0, 0,
+    /* ENERGEST_TYPE_TRANSMIT: 19.5 mA at 0 dBm, minus the MCU */
+    17700000,
+    /* ENERGEST_TYPE_LISTEN: 21.8 mA, minus the MCU */
+    20000000,
+    /* ENERGEST_TYPE_FLASH_READ, FLASH_WRITE: M25P80 */
+    4000000, 15000000,
+    /* ENERGEST_TYPE_SENSORS, SERIAL */
+    0, 0,
+  }
+};
+
+/* Picojoules per nanojoule, times rtimer ticks per second */
+#define DIVISOR ((uint64_t)RTIMER_ARCH_SECOND * 1000)
+
+static const struct energy_model_profile *profile = &ENERGY_MODEL_PROFILE;
+static struct energest_snapshot last;
+static uint64_t total[ENERGEST_TYPE_MAX];
+static uint64_t residue[ENERGEST_TYPE_MAX];
+#if ENERGY_MODEL_UPDATE_INTERVAL
+static struct ctimer update_timer;
+#endif /* ENERGY_MODEL_UPDATE_INTERVAL */
+
+/*---------------------------------------------------------------------------*/
+/* Power drawn in a state, in picowatts */
+static uint64_t
+power(int type)
+{
+  return (uint64_t)profile->current_na[type] * profile->voltage_mv;
+}
+/*---------------------------------------------------------------------------*/
+/* ticks * p / DIVISOR without overflow. The remainder of the division is
+   taken from and returned to *rest. */
+static uint64_t
+scale(uint64_t ticks, uint64_t p, uint64_t *rest)
+{
+  uint64_t max_chunk;
+  uint64_t chunk;
+  uint64_t work;
+  uint64_t result;
+
+  if(p == 0) {
+    return 0;
+  }
+
+  max_chunk = (UINT64_MAX - DIVISOR) / p;
+  result = 0;
+  while(ticks > 0) {
+    chunk = MIN(ticks, max_chunk);
+    work = chunk * p + *rest;
+    result += work / DIVISOR;
+    *rest = work % DIVISOR;
+    ticks -= chunk;
+  }
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+#if ENERGY_MODEL_UPDATE_INTERVAL
+static void
+update_timeout(void *ptr)
+{
+  energy_model_update();
+  ctimer_reset(&update_timer);
+}
+#endif /* ENERGY_MODEL_UPDATE_INTERVAL */
+/*---------------------------------------------------------------------------*/
+void
+energy_model_init(void)
+{
+  memset(total, 0, sizeof(total));
+  memset(residue, 0, sizeof(residue));
+  energest_snapshot(&last);
+#if ENERGY_MODEL_UPDATE_INTERVAL
+  ctimer_set(&update_timer, ENERGY_MODEL_UPDATE_INTERVAL, update_timeout, NULL);
+#endif /* ENERGY_MODEL_UPDATE_INTERVAL */
+}
+/*---------------------------------------------------------------------------*/
+void
+energy_model_set_profile(const struct energy_model_profile *p)
+{
+  energy_model_update();
+  profile = p;
+}
+/*---------------------------------------------------------------------------*/
+const struct energy_model_profile *
+energy_model_get_profile(void)
+{
+  return profile;
+}
+/*---------------------------------------------------------------------------*/
+void
+energy_model_update(void)
+{
+  struct energest_snapshot now;
+  int i;
+
+  energest_snapshot(&now);
+  for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+    total[i] += scale(energest_snapshot_diff(&last, &now, i), power(i),
+                      &residue[i]);
+  }
+  last = now;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+energy_model_total(int type)
+{
+  uint64_t sum;
+  int i;
+
+  energy_model_update();
+  if(type != ENERGY_MODEL_ALL) {
+    return total[type];
+  }
+  sum = 0;
+  for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+    sum += total[i];
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+void
+energy_model_snapshot(struct energy_model_snapshot *s)
+{
+  energest_snapshot(&s->energest);
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+energy_model_since(const struct energy_model_snapshot *s, int type)
+{
+  struct energest_snapshot now;
+  uint64_t sum;
+  int i;
+
+  energest_snapshot(&now);
+  if(type != ENERGY_MODEL_ALL) {
+    return energy_model_energy(type,
+                               energest_snapshot_diff(&s->energest, &now,
+                                                      type));
+  }
+  sum = 0;
+  for(i = 0; i < ENERGEST_TYPE_MAX; i++) {
+    sum += energy_model_energy(i, energest_snapshot_diff(&s->energest, &now,
+                                                         i));
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+energy_model_energy(int type, uint64_t ticks)
+{
+  uint64_t rest = 0;
+
+  return scale(ticks, power(type), &rest);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Energy accounting on top of Energest
+ *
+ *         The time Energest reports for every ENERGEST_TYPE_* state is
+ *         weighted with the current drawn in that state, taken from a
+ *         per-platform profile, and accumulated in nanojoules. The
+ *         remainder of every division is carried over, so that no energy
+ *         is lost to truncation however often the totals are updated.
+ */
+
+#ifndef ENERGY_MODEL_H_
+#define ENERGY_MODEL_H_
+
+#include "contiki-conf.h"
+#include "sys/energest.h"
+
+/* Current drawn in each state, on top of the states that are on at the
+   same time. Energest counts the CPU as active while the radio listens
+   or transmits, so radio currents must not include the MCU. */
+struct energy_model_profile {
+  const char *name;
+  /* Supply voltage in millivolts */
+  uint16_t voltage_mv;
+  /* Current in nanoamperes, indexed by ENERGEST_TYPE_* */
+  uint32_t current_na[ENERGEST_TYPE_MAX];
+};
+
+/* Tmote Sky at 3 V, from the datasheet. The radio figures are the
+   currents with the radio on minus the 1.8 mA of the active MCU. */
+extern const struct energy_model_profile energy_model_sky;
+
+/* Profile used unless energy_model_set_profile() is called */
+#ifdef ENERGY_MODEL_CONF_PROFILE
+#define ENERGY_MODEL_PROFILE ENERGY_MODEL_CONF_PROFILE
+#else
+#define ENERGY_MODEL_PROFILE energy_model_sky
+#endif
+
+/* Interval, in clock ticks, at which the totals are updated in the
+   background. The Energest counters do not wrap around, so this is
+   only useful to spread the cost of the updates. 0 disables the
+   background updates. */
+#ifdef ENERGY_MODEL_CONF_UPDATE_INTERVAL
+#define ENERGY_MODEL_UPDATE_INTERVAL ENERGY_MODEL_CONF_UPDATE_INTERVAL
+#else
+#define ENERGY_MODEL_UPDATE_INTERVAL 0
+#endif
+
+/* The type argument that sums all states */
+#define ENERGY_MODEL_ALL ENERGEST_TYPE_MAX
+
+/* Energest times of all states at one point in time */
+struct energy_model_snapshot {
+  struct energest_snapshot energest;
+};
+
+/**
+ * \brief      Start accounting from now on, with the default profile
+ */
+void energy_model_init(void);
+
+/**
+ * \brief      Change the current profile
+ *
+ *             Energy spent so far is accounted with the old profile
+ *             first.
+ */
+void energy_model_set_profile(const struct energy_model_profile *profile);
+const struct energy_model_profile *energy_model_get_profile(void);
+
+/**
+ * \brief      Fold the Energest times since the last update into the
+ *             totals
+ */
+void energy_model_update(void);
+
+/**
+ * \brief      Energy spent since energy_model_init()
+ * \param type An ENERGEST_TYPE_*, or ENERGY_MODEL_ALL
+ * \return     Energy in nanojoules
+ */
+uint64_t energy_model_total(int type);
+
+/**
+ * \brief      Record the Energest times of all states
+ *
+ *             All states are read at the same instant, see
+ *             energest_snapshot(). A snapshot can be taken, for
+ *             example, when a packet is queued.
+ */
+void energy_model_snapshot(struct energy_model_snapshot *s);
+
+/**
+ * \brief      Energy spent since a snapshot was taken
+ * \param s    The snapshot
+ * \param type An ENERGEST_TYPE_*, or ENERGY_MODEL_ALL
+ * \return     Energy in nanojoules
+ */
+uint64_t energy_model_since(const struct energy_model_snapshot *s, int type);
+
+/**
+ * \brief      Energy of a state over a duration
+ * \param type An ENERGEST_TYPE_*
+ * \param ticks Duration in rtimer ticks
+ * \return     Energy in nanojoules, rounded down
+ */
+uint64_t energy_model_energy(int type, uint64_t ticks);
+
+#endif /* ENERGY_MODEL_H_ */
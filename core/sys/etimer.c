@@ -49,95 +49,264 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
-static struct etimer *timerlist;
+/* Heap of pending timers: every timer expires no earlier than its
+   parent. The heap is a complete binary tree, timer number k (from 1,
+   in breadth-first order) is reached from the root by following the
+   bits of k below the highest one, 0 to the left, 1 to the right. */
+static struct etimer *root;
+static unsigned heap_size;
 static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+/* Ticks left before t expires, 0 if it has expired. As all timers count
+   down at the same rate, the order of two timers never changes, so the
+   heap stays valid over time. A timer counts as expired exactly when
+   timer_expired() says so: a timer whose start is one tick ahead, after
+   etimer_reset() one tick before it expired or etimer_adjust(), is not
+   expired yet, and put at the top of the heap it would hold up the
+   expired timers below it, as the poll handler does not fire it. A
+   timer started two or more ticks ahead does count as expired, and is
+   fired by the poll requested when it was added. */
+static clock_time_t
+time_left(struct etimer *t, clock_time_t now)
+{
+  clock_time_t elapsed = now - t->timer.start;
+
+  return timer_expired(&t->timer) ? 0 : t->timer.interval - elapsed;
+}
+/*---------------------------------------------------------------------------*/
+static int
+earlier(struct etimer *a, struct etimer *b, clock_time_t now)
+{
+  return time_left(a, now) < time_left(b, now);
+}
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
-  clock_time_t tdist;
   clock_time_t now;
-  struct etimer *t;
 
-  if (timerlist == NULL) {
+  if(root == NULL) {
     next_expiration = 0;
   } else {
     now = clock_time();
-    t = timerlist;
-    /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
-      if(t->timer.start + t->timer.interval - now < tdist) {
-	tdist = t->timer.start + t->timer.interval - now;
-      }
+    next_expiration = now + time_left(root, now);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct etimer *
+heap_node(unsigned k)
+{
+  struct etimer *t;
+  unsigned bit;
+
+  for(bit = 1; (bit << 1) <= k && (bit << 1) != 0; bit <<= 1);
+  t = root;
+  for(bit >>= 1; bit > 0; bit >>= 1) {
+    t = (k & bit) ? t->right : t->left;
+  }
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+/* Timers may be set for the first time in memory that was never
+   cleared, so nothing is read through the links of t itself: its index
+   is only trusted if walking the heap from the root leads back to t */
+static int
+on_heap(struct etimer *t)
+{
+  return t->p != PROCESS_NONE &&
+    t->index >= 1 && t->index <= heap_size && heap_node(t->index) == t;
+}
+/*---------------------------------------------------------------------------*/
+/* Put n in the place of o, a child of parent or the root */
+static void
+relink(struct etimer *parent, struct etimer *o, struct etimer *n)
+{
+  if(parent == NULL) {
+    root = n;
+  } else if(parent->left == o) {
+    parent->left = n;
+  } else {
+    parent->right = n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Swap c with its parent */
+static void
+swap_up(struct etimer *c)
+{
+  struct etimer *p = c->parent;
+  struct etimer *left = c->left;
+  struct etimer *right = c->right;
+  unsigned index = c->index;
+
+  c->index = p->index;
+  p->index = index;
+  relink(p->parent, p, c);
+  c->parent = p->parent;
+  if(p->left == c) {
+    c->left = p;
+    c->right = p->right;
+    if(c->right != NULL) {
+      c->right->parent = c;
+    }
+  } else {
+    c->right = p;
+    c->left = p->left;
+    if(c->left != NULL) {
+      c->left->parent = c;
     }
-    next_expiration = now + tdist;
+  }
+  p->parent = c;
+  p->left = left;
+  p->right = right;
+  if(left != NULL) {
+    left->parent = p;
+  }
+  if(right != NULL) {
+    right->parent = p;
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+sift_up(struct etimer *t, clock_time_t now)
+{
+  while(t->parent != NULL && earlier(t, t->parent, now)) {
+    swap_up(t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sift_down(struct etimer *t, clock_time_t now)
+{
+  struct etimer *c;
+
+  while(1) {
+    c = t->left;
+    if(c == NULL) {
+      return;
+    }
+    if(t->right != NULL && earlier(t->right, c, now)) {
+      c = t->right;
+    }
+    if(!earlier(c, t, now)) {
+      return;
+    }
+    swap_up(c);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Move t up or down to its place after its expiration time changed */
+static void
+sift(struct etimer *t, clock_time_t now)
+{
+  if(t->parent != NULL && earlier(t, t->parent, now)) {
+    sift_up(t, now);
+  } else {
+    sift_down(t, now);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  struct etimer *parent;
+
+  t->left = t->right = NULL;
+  heap_size++;
+  t->index = heap_size;
+  if(heap_size == 1) {
+    t->parent = NULL;
+    root = t;
+    return;
+  }
+  parent = heap_node(heap_size >> 1);
+  t->parent = parent;
+  if(heap_size & 1) {
+    parent->right = t;
+  } else {
+    parent->left = t;
+  }
+  sift_up(t, clock_time());
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  struct etimer *last;
+
+  /* The last timer of the heap takes the place of t */
+  last = heap_node(heap_size);
+  relink(last->parent, last, NULL);
+  heap_size--;
+
+  if(last != t) {
+    relink(t->parent, t, last);
+    last->parent = t->parent;
+    last->index = t->index;
+    last->left = t->left;
+    last->right = t->right;
+    if(last->left != NULL) {
+      last->left->parent = last;
+    }
+    if(last->right != NULL) {
+      last->right->parent = last;
+    }
+    sift(last, clock_time());
+  }
+  t->parent = t->left = t->right = NULL;
+  t->index = 0;
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
-	
+  struct etimer *t;
+  unsigned k;
+
   PROCESS_BEGIN();
 
-  timerlist = NULL;
-  
+  /* Timer events are posted as soon as the timers expire */
+  process_set_priority(&etimer_process, PROCESS_PRIORITY_HIGH);
+
   while(1) {
     PROCESS_YIELD();
 
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
-      while(timerlist != NULL && timerlist->p == p) {
-	timerlist = timerlist->next;
-      }
-
-      if(timerlist != NULL) {
-	t = timerlist;
-	while(t->next != NULL) {
-	  if(t->next->p == p) {
-	    t->next = t->next->next;
-	  } else
-	    t = t->next;
-	}
+      /* Rare, a plain scan that restarts after every removal will do */
+      for(k = 1; k <= heap_size; k++) {
+        t = heap_node(k);
+        if(t->p == p) {
+          heap_remove(t);
+          t->p = PROCESS_NONE;
+          k = 0;
+        }
       }
+      update_time();
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
-  again:
-    
-    u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-	  
-	  /* Reset the process ID of the event timer, to signal that the
-	     etimer has expired. This is later checked in the
-	     etimer_expired() function. */
-	  t->p = PROCESS_NONE;
-	  if(u != NULL) {
-	    u->next = t->next;
-	  } else {
-	    timerlist = t->next;
-	  }
-	  t->next = NULL;
-	  update_time();
-	  goto again;
-	} else {
-	  etimer_request_poll();
-	}
+    while(root != NULL && timer_expired(&root->timer)) {
+      t = root;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        heap_remove(t);
+        t->p = PROCESS_NONE;
+      } else {
+        /* The event queue is full, try again later */
+        etimer_request_poll();
+        break;
       }
-      u = t;
     }
-    
+    update_time();
   }
-  
+
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
@@ -150,25 +319,18 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
+  int pending;
 
   etimer_request_poll();
 
-  if(timer->p != PROCESS_NONE) {
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-	/* Timer already on list, bail out. */
-        timer->p = PROCESS_CURRENT();
-	update_time();
-	return;
-      }
-    }
-  }
-
-  /* Timer not on list. */
+  pending = on_heap(timer);
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
+  if(pending) {
+    /* The expiration time has changed, move the timer to its new place */
+    sift(timer, clock_time());
+  } else {
+    heap_insert(timer);
+  }
 
   update_time();
 }
@@ -206,6 +368,9 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+  if(on_heap(et)) {
+    sift(et, clock_time());
+  }
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -230,7 +395,7 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
-  return timerlist != NULL;
+  return root != NULL;
 }
 /*---------------------------------------------------------------------------*/
 clock_time_t
@@ -239,32 +404,20 @@ etimer_next_expiration_time(void)
   return etimer_pending() ? next_expiration : 0;
 }
 /*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_time_to_next_expiration(void)
+{
+  return root != NULL ? time_left(root, clock_time()) : 0;
+}
+/*---------------------------------------------------------------------------*/
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
+  if(on_heap(et)) {
+    heap_remove(et);
     update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-	 to remove. We point the items next pointer to the event after
-	 the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
   }
 
-  /* Remove the next pointer from the item to be removed. */
-  et->next = NULL;
   /* Set the timer as expired */
   et->p = PROCESS_NONE;
 }
@@ -53,6 +53,11 @@
  * to the event timer is made by a pointer to the declared event
  * timer.
  *
+ * Pending event timers are kept in a binary heap ordered by the time
+ * left until they expire. Setting or stopping a timer takes
+ * O(log n) steps, finding the next expiration O(1), and each expired
+ * timer is removed in O(log n).
+ *
  * \sa \ref timer "Simple timer library"
  * \sa \ref clock "Clock library" (used by the timer library)
  *
@@ -75,7 +80,11 @@
  */
 struct etimer {
   struct timer timer;
-  struct etimer *next;
+  /* Links of the heap of pending timers, and the position in it */
+  struct etimer *parent;
+  struct etimer *left;
+  struct etimer *right;
+  unsigned index;
   struct process *p;
 };
 
@@ -245,6 +254,19 @@ int etimer_pending(void);
  */
 clock_time_t etimer_next_expiration_time(void);
 
+/**
+ * \brief      Get the time until the next event timer expires.
+ * \return     Clock ticks until the earliest pending event timer
+ *             expires, 0 if it already has. If there are no pending
+ *             event timers this function returns 0.
+ *
+ *             Unlike etimer_next_expiration_time(), the result does not
+ *             have to be compared with clock_time(), which would be
+ *             wrong for a timer that expired more than half the clock
+ *             range ago.
+ */
+clock_time_t etimer_time_to_next_expiration(void);
+
 
 /** @} */
 
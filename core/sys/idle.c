@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Time until the next deadline of the system
+ */
+
+#include "sys/idle.h"
+#include "sys/etimer.h"
+#include "sys/process.h"
+#include "sys/rtimer.h"
+
+/*---------------------------------------------------------------------------*/
+clock_time_t
+idle_time(void)
+{
+  clock_time_t left = IDLE_TIME_FOREVER;
+  clock_time_t until_rtimer;
+  rtimer_clock_t due;
+  long diff;
+
+  if(process_nevents() > 0) {
+    return 0;
+  }
+
+  if(etimer_pending()) {
+    left = etimer_time_to_next_expiration();
+  }
+
+  if(left > 0 && rtimer_next_time(&due)) {
+    diff = RTIMER_CLOCK_DIFF(due, RTIMER_NOW());
+    if(diff <= 0) {
+      return 0;
+    }
+    until_rtimer = (clock_time_t)(((uint64_t)diff * CLOCK_SECOND +
+                                   RTIMER_SECOND - 1) / RTIMER_SECOND);
+    if(until_rtimer < left) {
+      left = until_rtimer;
+    }
+  }
+
+  return left;
+}
+/*---------------------------------------------------------------------------*/
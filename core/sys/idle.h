@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Time until the next deadline of the system, for tickless
+ *         idle in the main loop of a platform.
+ *
+ *         A main loop that sleeps for idle_time() after process_run()
+ *         wakes up when an event timer, callback timer or real-time
+ *         task is due, and not at every clock tick in between:
+ *
+ *           while(1) {
+ *             process_run();
+ *             ticks = idle_time();
+ *             if(ticks > 0) {
+ *               sleep for ticks, or until an interrupt if IDLE_TIME_FOREVER
+ *             }
+ *             if(etimer_pending() && etimer_time_to_next_expiration() == 0) {
+ *               etimer_request_poll();
+ *             }
+ *           }
+ */
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+#include "contiki-conf.h"
+#include "sys/clock.h"
+
+/* Returned by idle_time() when nothing is scheduled */
+#define IDLE_TIME_FOREVER ((clock_time_t)~(clock_time_t)0)
+
+/**
+ * \brief      Get the time the system may sleep
+ * \return     Clock ticks until the earliest deadline, 0 if a poll or
+ *             event is pending, or IDLE_TIME_FOREVER if no timer is
+ *             pending
+ *
+ *             The deadlines are those of the event timers, which also
+ *             run the callback timers, and of the real-time task. The
+ *             time until a real-time task is rounded up to a whole
+ *             clock tick, as its own interrupt ends the sleep.
+ */
+clock_time_t idle_time(void);
+
+#endif /* IDLE_H_ */
@@ -47,6 +47,9 @@
 
 #include "sys/process.h"
 #include "sys/arg.h"
+#if PROCESS_CONF_LATENCY_STATS
+#include "sys/rtimer.h"
+#endif /* PROCESS_CONF_LATENCY_STATS */
 
 /*
  * Pointer to the currently running process structure.
@@ -63,11 +66,23 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_CONF_LATENCY_STATS
+  rtimer_clock_t posted;
+#endif /* PROCESS_CONF_LATENCY_STATS */
 };
 
 static process_num_events_t nevents, fevent;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
+#if PROCESS_CONF_WITH_PRIORITIES
+/* Events to processes of high priority */
+static process_num_events_t nhevents, fhevent;
+static struct event_data hevents[PROCESS_CONF_NUMEVENTS_HIGH];
+#define NHEVENTS nhevents
+#else
+#define NHEVENTS 0
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
 #endif
@@ -210,6 +225,9 @@ process_init(void)
   lastevent = PROCESS_EVENT_MAX;
 
   nevents = fevent = 0;
+#if PROCESS_CONF_WITH_PRIORITIES
+  nhevents = fhevent = 0;
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
 #endif /* PROCESS_CONF_STATS */
@@ -227,6 +245,16 @@ do_poll(void)
   struct process *p;
 
   poll_requested = 0;
+#if PROCESS_CONF_WITH_PRIORITIES
+  /* Processes of high priority first */
+  for(p = process_list; p != NULL; p = p->next) {
+    if(p->needspoll && p->priority > PROCESS_PRIORITY_NORMAL) {
+      p->state = PROCESS_STATE_RUNNING;
+      p->needspoll = 0;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+    }
+  }
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
   /* Call the processes that needs to be polled. */
   for(p = process_list; p != NULL; p = p->next) {
     if(p->needspoll) {
@@ -237,6 +265,86 @@ do_poll(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_LATENCY_STATS
+static void
+count_latency(struct process *p, rtimer_clock_t posted)
+{
+  unsigned long latency = (rtimer_clock_t)(RTIMER_NOW() - posted);
+
+  if(p->state & PROCESS_STATE_RUNNING) {
+    p->latency.events++;
+    p->latency.total += latency;
+    if(latency > p->latency.max) {
+      p->latency.max = latency;
+    }
+  }
+}
+#define COUNT_LATENCY(p, e) count_latency(p, (e)->posted)
+#else
+#define COUNT_LATENCY(p, e)
+#endif /* PROCESS_CONF_LATENCY_STATS */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_WITH_PRIORITIES
+static void deliver_event(struct event_data *e);
+
+/*
+ * Deliver all events to processes of high priority.
+ */
+static void
+do_high_events(void)
+{
+  struct event_data e;
+
+  while(nhevents > 0) {
+    e = hevents[fhevent];
+    fhevent = (fhevent + 1) % PROCESS_CONF_NUMEVENTS_HIGH;
+    --nhevents;
+    deliver_event(&e);
+  }
+}
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+/*---------------------------------------------------------------------------*/
+/*
+ * Deliver an event that has been taken off the queue.
+ */
+static void
+deliver_event(struct event_data *e)
+{
+  struct process *p;
+
+  /* If this is a broadcast event, we deliver it to all events, in
+     order of their priority. */
+  if(e->p == PROCESS_BROADCAST) {
+    for(p = process_list; p != NULL; p = p->next) {
+
+      /* If we have been requested to poll a process, we do this in
+	 between processing the broadcast event. */
+      if(poll_requested) {
+	do_poll();
+      }
+#if PROCESS_CONF_WITH_PRIORITIES
+      /* Likewise, events to processes of high priority do not wait
+	 for the broadcast to reach every process */
+      do_high_events();
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+      COUNT_LATENCY(p, e);
+      call_process(p, e->ev, e->data);
+    }
+  } else {
+    /* This is not a broadcast event, so we deliver it to the
+       specified process. */
+    /* If the event was an INIT event, we should also update the
+       state of the process. */
+    if(e->ev == PROCESS_EVENT_INIT) {
+      e->p->state = PROCESS_STATE_RUNNING;
+    }
+
+    /* Make sure that the process actually is running. */
+    COUNT_LATENCY(e->p, e);
+    call_process(e->p, e->ev, e->data);
+  }
+}
+/*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
  * listening processes.
@@ -245,10 +353,7 @@ do_poll(void)
 static void
 do_event(void)
 {
-  process_event_t ev;
-  process_data_t data;
-  struct process *receiver;
-  struct process *p;
+  struct event_data e;
   
   /*
    * If there are any events in the queue, take the first one and walk
@@ -258,43 +363,28 @@ do_event(void)
    * call the poll handlers inbetween.
    */
 
+#if PROCESS_CONF_WITH_PRIORITIES
+  /* Events to processes of high priority go first */
+  if(nhevents > 0) {
+    e = hevents[fhevent];
+    fhevent = (fhevent + 1) % PROCESS_CONF_NUMEVENTS_HIGH;
+    --nhevents;
+    deliver_event(&e);
+    return;
+  }
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
   if(nevents > 0) {
     
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
-    
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    e = events[fevent];
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
     fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
     --nevents;
 
-    /* If this is a broadcast event, we deliver it to all events, in
-       order of their priority. */
-    if(receiver == PROCESS_BROADCAST) {
-      for(p = process_list; p != NULL; p = p->next) {
-
-	/* If we have been requested to poll a process, we do this in
-	   between processing the broadcast event. */
-	if(poll_requested) {
-	  do_poll();
-	}
-	call_process(p, ev, data);
-      }
-    } else {
-      /* This is not a broadcast event, so we deliver it to the
-	 specified process. */
-      /* If the event was an INIT event, we should also update the
-	 state of the process. */
-      if(ev == PROCESS_EVENT_INIT) {
-	receiver->state = PROCESS_STATE_RUNNING;
-      }
-
-      /* Make sure that the process actually is running. */
-      call_process(receiver, ev, data);
-    }
+    deliver_event(&e);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -309,13 +399,13 @@ process_run(void)
   /* Process one event from the queue */
   do_event();
 
-  return nevents + poll_requested;
+  return nevents + NHEVENTS + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
 int
 process_nevents(void)
 {
-  return nevents + poll_requested;
+  return nevents + NHEVENTS + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -332,6 +422,26 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
   
+#if PROCESS_CONF_WITH_PRIORITIES
+  if(p != PROCESS_BROADCAST && p->priority > PROCESS_PRIORITY_NORMAL) {
+    if(nhevents == PROCESS_CONF_NUMEVENTS_HIGH) {
+#if DEBUG
+      printf("soft panic: high priority event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
+#endif /* DEBUG */
+      return PROCESS_ERR_FULL;
+    }
+    snum = (process_num_events_t)(fhevent + nhevents) % PROCESS_CONF_NUMEVENTS_HIGH;
+    hevents[snum].ev = ev;
+    hevents[snum].data = data;
+    hevents[snum].p = p;
+#if PROCESS_CONF_LATENCY_STATS
+    hevents[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_CONF_LATENCY_STATS */
+    ++nhevents;
+    return PROCESS_ERR_OK;
+  }
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
   if(nevents == PROCESS_CONF_NUMEVENTS) {
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
@@ -347,6 +457,9 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
+#if PROCESS_CONF_LATENCY_STATS
+  events[snum].posted = RTIMER_NOW();
+#endif /* PROCESS_CONF_LATENCY_STATS */
   ++nevents;
 
 #if PROCESS_CONF_STATS
@@ -385,4 +498,24 @@ process_is_running(struct process *p)
   return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_WITH_PRIORITIES
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  p->priority = priority;
+}
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_LATENCY_STATS
+void
+process_latency_reset(void)
+{
+  struct process *p;
+
+  for(p = process_list; p != NULL; p = p->next) {
+    p->latency.events = p->latency.total = p->latency.max = 0;
+  }
+}
+#endif /* PROCESS_CONF_LATENCY_STATS */
+/*---------------------------------------------------------------------------*/
 /** @} */
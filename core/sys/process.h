@@ -88,6 +88,27 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/* With PROCESS_CONF_WITH_PRIORITIES, processes of high priority are
+   polled before all others, and events posted to them go to a queue of
+   their own that is emptied before the normal one. */
+#ifndef PROCESS_CONF_WITH_PRIORITIES
+#define PROCESS_CONF_WITH_PRIORITIES 0
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
+/* Size of the queue of events to high priority processes */
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH 8
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+/* With PROCESS_CONF_LATENCY_STATS, every process counts the time its
+   events spent in the queue, see struct process_latency */
+#ifndef PROCESS_CONF_LATENCY_STATS
+#define PROCESS_CONF_LATENCY_STATS 0
+#endif /* PROCESS_CONF_LATENCY_STATS */
+
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -312,6 +333,14 @@ static PT_THREAD(process_thread_##name(struct pt *process_pt,	\
 
 /** @} */
 
+/* Time from process_post() to the delivery of the event, in rtimer
+   ticks. Synchronous events are not counted. */
+struct process_latency {
+  unsigned long events;
+  unsigned long total;
+  unsigned long max;
+};
+
 struct process {
   struct process *next;
 #if PROCESS_CONF_NO_PROCESS_NAMES
@@ -323,6 +352,12 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_WITH_PRIORITIES
+  unsigned char priority;
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+#if PROCESS_CONF_LATENCY_STATS
+  struct process_latency latency;
+#endif /* PROCESS_CONF_LATENCY_STATS */
 };
 
 /**
@@ -389,6 +424,31 @@ CCIF void process_post_synch(struct process *p,
  */
 CCIF void process_exit(struct process *p);
 
+/**
+ * \brief      Set the scheduling priority of a process
+ * \param p    The process
+ * \param priority PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH
+ *
+ *             Processes of high priority are polled first, and events
+ *             posted to them are delivered before any queued event to
+ *             a normal process. Broadcast events always have normal
+ *             priority. Events already queued for the process stay in
+ *             their queue, so the priority is best set when the process
+ *             starts. Does nothing without PROCESS_CONF_WITH_PRIORITIES.
+ */
+#if PROCESS_CONF_WITH_PRIORITIES
+CCIF void process_set_priority(struct process *p, unsigned char priority);
+#else
+#define process_set_priority(p, priority)
+#endif /* PROCESS_CONF_WITH_PRIORITIES */
+
+#if PROCESS_CONF_LATENCY_STATS
+/**
+ * \brief      Clear the latency statistics of all processes
+ */
+void process_latency_reset(void);
+#endif /* PROCESS_CONF_LATENCY_STATS */
+
 
 /**
  * Get a pointer to the currently running process.
@@ -104,5 +104,15 @@ rtimer_run_next(void)
   return;
 }
 /*---------------------------------------------------------------------------*/
+int
+rtimer_next_time(rtimer_clock_t *time)
+{
+  if(next_rtimer == NULL) {
+    return 0;
+  }
+  *time = next_rtimer->time;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 
 /** @}*/
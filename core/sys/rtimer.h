@@ -122,6 +122,13 @@ int rtimer_set(struct rtimer *task, rtimer_clock_t time,
  */
 void rtimer_run_next(void);
 
+/**
+ * \brief      Get the time of the scheduled real-time task
+ * \param time Set to the time the task is due, if there is one
+ * \return     Non-zero if a real-time task is scheduled
+ */
+int rtimer_next_time(rtimer_clock_t *time);
+
 /**
  * \brief      Get the current clock time
  * \return     The current time
@@ -18,6 +18,7 @@
 // battery
 #include "dev/battery-sensor.h"
 #include "powertrace.h"
+#include "sys/energy-model.h"
 
 // VARIAVEIS DO TMOTE SKY
 #define _Nb 90  // tamanho do pacote
@@ -25,12 +26,7 @@ static uint32_t _Eihop, _P0;
 static uint8_t _Dist = 135;
 static uint8_t _R = 250;  // TMOTE SKY
 
-// VARIAVEIS DO TMOTE SKY (mA)
-static double voltage = 3.6;  // Volts
-static double tx = 0.0195 * 1000;
-static double rx = 0.0218 * 1000;
-static double cpu = 0.0000545 * 1000;
-static double cpu_stand = 0.0000051 * 1000;
+// Correntes do Tmote Sky: energy_model_sky em core/sys/energy-model.c
 
 // DADOS DE TRABNSMISSAO
 static struct collect_conn tc;
@@ -39,44 +35,20 @@ static struct collect_conn tc;
 /*-------------------------------CODE----------------------------------------*/
 /*---------------------------battery status-----------------------------------*/
 void powertrace_print(char *str) {
-  static uint32_t last_cpu, last_lpm, last_transmit, last_listen;
-  uint32_t current_cpu, current_idle, current_tx_mode, current_rx_mode;
-  uint32_t all_cpu, all_lpm, all_transmit, all_listen;
-
-  uint32_t current, charge, power, energy;
-
-  all_cpu = energest_type_time(ENERGEST_TYPE_CPU);
-  all_lpm = energest_type_time(ENERGEST_TYPE_LPM);
-  all_transmit = energest_type_time(ENERGEST_TYPE_TRANSMIT);
-  all_listen = energest_type_time(ENERGEST_TYPE_LISTEN);
-
-  current_cpu = all_cpu - last_cpu;
-  current_idle = all_lpm - last_lpm;
-  current_tx_mode = all_transmit - last_transmit;
-  current_rx_mode = all_listen - last_listen;
-
-  energest_flush();
-
-  // INSERIR NO INICIO DA TRANSMISSAO
-  last_cpu = energest_type_time(ENERGEST_TYPE_CPU);
-  last_lpm = energest_type_time(ENERGEST_TYPE_LPM);
-  last_transmit = energest_type_time(ENERGEST_TYPE_TRANSMIT);
-  last_listen = energest_type_time(ENERGEST_TYPE_LISTEN);
-
-  current = (tx * current_tx_mode + rx * current_rx_mode + cpu * current_cpu +
-             cpu_stand * current_idle) /
-            RTIMER_ARCH_SECOND;
-
-  charge = current * (current_cpu + current_idle) / RTIMER_ARCH_SECOND;
-  power = current * voltage;
-  energy = charge * voltage;
-
-  // printf("power: %u.%02u mW\n",(uint16_t)power/1000,(uint16_t)power%1000);
-  // printf("consumption: %u.%02u
-  // mJ\n\n",(uint16_t)energy/1000,(uint16_t)energy%1000);
-
-  _Eihop = energy;
-  _P0 = power;
+  static struct energy_model_snapshot last;
+  static clock_time_t last_time;
+  clock_time_t elapsed;
+  uint64_t energy;
+
+  // Energia (nJ) desde a ultima chamada
+  energy = energy_model_since(&last, ENERGY_MODEL_ALL);
+  elapsed = clock_time() - last_time;
+  energy_model_snapshot(&last);
+  last_time = clock_time();
+
+  // uJ e uW
+  _Eihop = energy / 1000;
+  _P0 = elapsed > 0 ? energy * CLOCK_SECOND / elapsed / 1000 : 0;
 }
 
 /*---------------------------transmission------------------------------------*/
@@ -116,8 +88,10 @@ PROCESS_THREAD(example_collect_process, ev, data) {
   // char *packet = malloc(_Nb);
   char packet[_Nb];
   // "abcedefghijklmnopqrstuvwxyzabcedefghijklmnopqrstuvwxyz";
-  sprintf(packet, "%u.%02u,%u.%02u", (uint16_t)_Eihop / 1000,
-          (uint16_t)_Eihop % 1000, (uint16_t)_P0 / 1000, (uint16_t)_P0 % 1000);
+  // mJ e mW
+  sprintf(packet, "%lu.%02lu,%lu.%02lu", (unsigned long)_Eihop / 1000,
+          (unsigned long)(_Eihop % 1000) / 10, (unsigned long)_P0 / 1000,
+          (unsigned long)(_P0 % 1000) / 10);
 
   PROCESS_BEGIN();
 
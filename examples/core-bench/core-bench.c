@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Microbenchmarks of the core data structures, for the native
+ *         platform.
+ *
+ *         Every benchmark repeats one operation, at a size typical of a
+ *         sensor node, and prints one line:
+ *
+ *           #B <name> <size> <ops> <ops/s> <mean ns> <p99 ns> <max ns>
+ *
+ *         The throughput is measured over all ops in one go. The latency
+ *         figures come from a second run that times every op on its own,
+ *         with the cost of reading the clock subtracted. On a host, the
+ *         maximum mostly shows preemption by the OS, the 99th percentile
+ *         is the figure to watch. compare-bench compares two outputs.
+ */
+
+#include "contiki.h"
+#include "lib/list.h"
+#include "lib/memb.h"
+#include "lib/mmem.h"
+#include "lib/ringbuf.h"
+#include "lib/ringbufindex.h"
+#include "net/linkaddr.h"
+#include "net/nbr-table.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef CORE_BENCH_CONF_OPS
+#define OPS CORE_BENCH_CONF_OPS
+#else
+#define OPS 200000
+#endif
+
+struct bench {
+  const char *name;
+  int size;
+  void (* setup)(int size);
+  void (* op)(unsigned i);
+};
+
+static int size;
+static uint64_t clock_overhead;
+static uint32_t samples[OPS];
+
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+/* list: add an item at the tail and remove it again, with size items
+   already on the list */
+struct item {
+  struct item *next;
+  int value;
+};
+#define LIST_ITEMS 64
+static struct item items[LIST_ITEMS + 1];
+LIST(bench_list);
+
+static void
+list_setup(int n)
+{
+  int i;
+
+  list_init(bench_list);
+  for(i = 0; i < n; i++) {
+    list_add(bench_list, &items[i]);
+  }
+}
+static void
+list_op(unsigned i)
+{
+  list_add(bench_list, &items[LIST_ITEMS]);
+  list_remove(bench_list, &items[LIST_ITEMS]);
+}
+/*---------------------------------------------------------------------------*/
+/* memb: allocate and free one block, with half of the blocks in use */
+#define MEMB_BLOCKS 64
+MEMB(bench_memb, struct item, MEMB_BLOCKS);
+
+static void
+memb_setup(int n)
+{
+  int i;
+
+  memb_init(&bench_memb);
+  for(i = 0; i < n; i++) {
+    memb_alloc(&bench_memb);
+  }
+}
+static void
+memb_op(unsigned i)
+{
+  memb_free(&bench_memb, memb_alloc(&bench_memb));
+}
+/*---------------------------------------------------------------------------*/
+/* mmem: free the oldest of size live allocations of 32 bytes and
+   allocate a new one */
+#define MMEM_BLOCKS 64
+static struct mmem mmems[MMEM_BLOCKS];
+
+static void
+mmem_setup(int n)
+{
+  int i;
+
+  mmem_init();
+  for(i = 0; i < MMEM_BLOCKS; i++) {
+    mmem_free(&mmems[i]);
+  }
+  for(i = 0; i < n; i++) {
+    mmem_alloc(&mmems[i], 32);
+  }
+}
+static void
+mmem_op(unsigned i)
+{
+  struct mmem *m = &mmems[i % size];
+
+  mmem_free(m);
+  mmem_alloc(m, 32);
+}
+/*---------------------------------------------------------------------------*/
+/* ringbuf: put and get one byte, with size bytes buffered */
+static struct ringbuf rb;
+static uint8_t rb_data[128];
+
+static void
+ringbuf_setup(int n)
+{
+  int i;
+
+  ringbuf_init(&rb, rb_data, sizeof(rb_data));
+  for(i = 0; i < n; i++) {
+    ringbuf_put(&rb, i);
+  }
+}
+static void
+ringbuf_op(unsigned i)
+{
+  ringbuf_put(&rb, i);
+  ringbuf_get(&rb);
+}
+/*---------------------------------------------------------------------------*/
+/* ringbufindex: put and get one index, with size indices used */
+static struct ringbufindex rbi;
+
+static void
+ringbufindex_setup(int n)
+{
+  int i;
+
+  ringbufindex_init(&rbi, 64);
+  for(i = 0; i < n; i++) {
+    ringbufindex_put(&rbi);
+  }
+}
+static void
+ringbufindex_op(unsigned i)
+{
+  if(ringbufindex_peek_put(&rbi) >= 0) {
+    ringbufindex_put(&rbi);
+  }
+  ringbufindex_get(&rbi);
+}
+/*---------------------------------------------------------------------------*/
+/* nbr-table: look up one of size neighbors by address */
+NBR_TABLE(struct item, bench_nbrs);
+static int nbrs;
+static int nbrs_registered;
+
+static void
+nbr_table_setup(int n)
+{
+  linkaddr_t addr;
+  struct item *item;
+
+  if(!nbrs_registered) {
+    nbr_table_register(bench_nbrs, NULL);
+    nbrs_registered = 1;
+  }
+  for(item = nbr_table_head(bench_nbrs); item != NULL;
+      item = nbr_table_head(bench_nbrs)) {
+    nbr_table_remove(bench_nbrs, item);
+  }
+  memset(&addr, 0, sizeof(addr));
+  for(nbrs = 0; nbrs < n; nbrs++) {
+    addr.u8[0] = nbrs + 1;
+    if(nbr_table_add_lladdr(bench_nbrs, &addr,
+                            NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      break;
+    }
+  }
+  size = nbrs;
+}
+static void
+nbr_table_op(unsigned i)
+{
+  linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = i % nbrs + 1;
+  nbr_table_get_from_lladdr(bench_nbrs, &addr);
+}
+/*---------------------------------------------------------------------------*/
+/* packetbuf: build a packet of size bytes with a header and attributes,
+   as a MAC layer does before sending */
+static uint8_t payload[PACKETBUF_SIZE];
+
+static void
+packetbuf_setup(int n)
+{
+  memset(payload, 0x55, sizeof(payload));
+}
+static void
+packetbuf_op(unsigned i)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, size);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, i);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  packetbuf_hdralloc(16);
+  packetbuf_compact();
+}
+/*---------------------------------------------------------------------------*/
+/* queuebuf: copy a packet of size bytes to a queuebuf and back */
+static void
+queuebuf_setup(int n)
+{
+  packetbuf_setup(n);
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, n);
+}
+static void
+queuebuf_op(unsigned i)
+{
+  struct queuebuf *q;
+
+  q = queuebuf_new_from_packetbuf();
+  if(q != NULL) {
+    queuebuf_to_packetbuf(q);
+    queuebuf_free(q);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* etimer: set one of size pending timers again with another interval.
+   The clock does not advance during a run, so no timer expires. */
+#define ETIMERS 64
+static struct etimer etimers[ETIMERS];
+
+static void
+etimer_setup(int n)
+{
+  int i;
+
+  for(i = 0; i < ETIMERS; i++) {
+    etimer_stop(&etimers[i]);
+  }
+  for(i = 0; i < n; i++) {
+    etimer_set(&etimers[i], CLOCK_SECOND + i);
+  }
+}
+static void
+etimer_op(unsigned i)
+{
+  etimer_set(&etimers[i % size], CLOCK_SECOND + (i * 37) % CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "list-add-remove", 8, list_setup, list_op },
+  { "list-add-remove", 32, list_setup, list_op },
+  { "memb-alloc-free", MEMB_BLOCKS / 2, memb_setup, memb_op },
+  { "mmem-free-alloc", 16, mmem_setup, mmem_op },
+  { "mmem-free-alloc", 64, mmem_setup, mmem_op },
+  { "ringbuf-put-get", 64, ringbuf_setup, ringbuf_op },
+  { "ringbufindex-put-get", 32, ringbufindex_setup, ringbufindex_op },
+  { "nbr-table-lookup", 8, nbr_table_setup, nbr_table_op },
+  { "nbr-table-lookup", NBR_TABLE_MAX_NEIGHBORS, nbr_table_setup, nbr_table_op },
+  { "packetbuf-build", 32, packetbuf_setup, packetbuf_op },
+  { "packetbuf-build", 100, packetbuf_setup, packetbuf_op },
+  { "queuebuf-copy", 32, queuebuf_setup, queuebuf_op },
+  { "queuebuf-copy", 100, queuebuf_setup, queuebuf_op },
+  { "etimer-set", 8, etimer_setup, etimer_op },
+  { "etimer-set", ETIMERS, etimer_setup, etimer_op },
+};
+/*---------------------------------------------------------------------------*/
+static int
+compare_samples(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(const struct bench *b)
+{
+  uint64_t start, t, elapsed, sum;
+  unsigned i;
+
+  size = b->size;
+  b->setup(size);
+
+  start = now_ns();
+  for(i = 0; i < OPS; i++) {
+    b->op(i);
+  }
+  elapsed = now_ns() - start;
+
+  sum = 0;
+  for(i = 0; i < OPS; i++) {
+    start = now_ns();
+    b->op(i);
+    t = now_ns() - start;
+    t = t > clock_overhead ? t - clock_overhead : 0;
+    samples[i] = t > UINT32_MAX ? UINT32_MAX : t;
+    sum += t;
+  }
+  qsort(samples, OPS, sizeof(samples[0]), compare_samples);
+
+  printf("#B %s %d %u %.0f %.1f %lu %lu\n", b->name, size, OPS,
+         elapsed > 0 ? OPS * 1e9 / elapsed : 0.0,
+         (double)sum / OPS,
+         (unsigned long)samples[OPS - 1 - OPS / 100],
+         (unsigned long)samples[OPS - 1]);
+}
+/*---------------------------------------------------------------------------*/
+static void
+calibrate(void)
+{
+  uint64_t start, t;
+  int i;
+
+  clock_overhead = ~0ULL;
+  for(i = 0; i < 1000; i++) {
+    start = now_ns();
+    t = now_ns() - start;
+    if(t < clock_overhead) {
+      clock_overhead = t;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(core_bench_process, "Core benchmarks");
+AUTOSTART_PROCESSES(&core_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(core_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  calibrate();
+  printf("#B name size ops ops/s mean-ns p99-ns max-ns\n");
+  for(i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+    run(&benches[i]);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Single-hop traffic for comparing MAC and RDC layers
+ *
+ *         Node 1 is the sink, every other node sends it a unicast packet
+ *         of PAYLOAD_LEN bytes every SEND_INTERVAL_MS on average, with
+ *         random jitter. Traffic starts after WARMUP_SECONDS, which
+ *         leaves time for TSCH to associate.
+ *
+ *         All output is meant for netstack-bench-report and
+ *         tools/aloha-model:
+ *
+ *           #NB tx <node> <seqno> <len>       packet handed to Rime
+ *           #NB sent <node> <num_tx> <status> outcome reported by the MAC
+ *           #NB rx <from> <seqno> <len>       packet received by the sink
+ *           #NB energy <node> <uJ> <seconds>  energy since the warmup
+ *
+ *         Latency is taken from the simulation time of the tx and rx
+ *         lines, the clocks of the nodes are never compared.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/netstack.h"
+#include "net/rime/rime.h"
+#include "sys/energy-model.h"
+#if NETSTACK_BENCH_TSCH
+#include "net/mac/tsch/tsch.h"
+#endif /* NETSTACK_BENCH_TSCH */
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef SEND_INTERVAL_MS
+#define SEND_INTERVAL_MS 5000
+#endif
+
+#ifndef PAYLOAD_LEN
+#define PAYLOAD_LEN 32
+#endif
+
+#ifndef WARMUP_SECONDS
+#define WARMUP_SECONDS 60
+#endif
+
+#define REPORT_INTERVAL (10 * CLOCK_SECOND)
+
+#define SEND_INTERVAL MAX((clock_time_t)SEND_INTERVAL_MS * CLOCK_SECOND / 1000, 2)
+
+#define CHANNEL 150
+
+struct bench_msg {
+  uint16_t seqno;
+  uint8_t pad[PAYLOAD_LEN - 2];
+};
+
+static const linkaddr_t sink_addr = { { 1, 0 } };
+static struct unicast_conn uc;
+static struct energy_model_snapshot start;
+static clock_time_t start_time;
+
+/*---------------------------------------------------------------------------*/
+static void
+recv_uc(struct unicast_conn *c, const linkaddr_t *from)
+{
+  struct bench_msg msg;
+
+  if(packetbuf_datalen() < sizeof(msg.seqno)) {
+    return;
+  }
+  memcpy(&msg.seqno, packetbuf_dataptr(), sizeof(msg.seqno));
+  printf("#NB rx %u %u %u\n", from->u8[0], msg.seqno, packetbuf_datalen());
+}
+/*---------------------------------------------------------------------------*/
+static void
+sent_uc(struct unicast_conn *c, int status, int num_tx)
+{
+  printf("#NB sent %u %d %d\n", linkaddr_node_addr.u8[0], num_tx, status);
+}
+/*---------------------------------------------------------------------------*/
+static const struct unicast_callbacks unicast_callbacks = { recv_uc, sent_uc };
+/*---------------------------------------------------------------------------*/
+static void
+report_energy(void)
+{
+  printf("#NB energy %u %lu %lu\n", linkaddr_node_addr.u8[0],
+         (unsigned long)(energy_model_since(&start, ENERGY_MODEL_ALL) / 1000),
+         (unsigned long)((clock_time() - start_time) / CLOCK_SECOND));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(netstack_bench_process, "Netstack benchmark");
+AUTOSTART_PROCESSES(&netstack_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(netstack_bench_process, ev, data)
+{
+  static struct etimer send_timer;
+  static struct etimer report_timer;
+  static struct bench_msg msg;
+  static int is_sink;
+
+  PROCESS_BEGIN();
+
+  is_sink = linkaddr_cmp(&linkaddr_node_addr, &sink_addr);
+#if NETSTACK_BENCH_TSCH
+  tsch_set_coordinator(is_sink);
+#endif /* NETSTACK_BENCH_TSCH */
+  NETSTACK_MAC.on();
+
+  unicast_open(&uc, CHANNEL, &unicast_callbacks);
+  memset(&msg, 0, sizeof(msg));
+
+  etimer_set(&send_timer, WARMUP_SECONDS * CLOCK_SECOND);
+  PROCESS_WAIT_UNTIL(etimer_expired(&send_timer));
+
+  energy_model_snapshot(&start);
+  start_time = clock_time();
+  etimer_set(&report_timer, REPORT_INTERVAL);
+  etimer_set(&send_timer, random_rand() % SEND_INTERVAL);
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&send_timer) ||
+                             etimer_expired(&report_timer));
+
+    if(etimer_expired(&report_timer)) {
+      etimer_reset(&report_timer);
+      report_energy();
+    }
+
+    if(etimer_expired(&send_timer)) {
+      /* Uniform jitter around the mean interval */
+      etimer_set(&send_timer, SEND_INTERVAL / 2 + random_rand() % SEND_INTERVAL);
+      if(!is_sink) {
+        msg.seqno++;
+        packetbuf_copyfrom(&msg, sizeof(msg));
+        printf("#NB tx %u %u %u\n", linkaddr_node_addr.u8[0], msg.seqno,
+               (unsigned)sizeof(msg));
+        unicast_send(&uc, &sink_addr);
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
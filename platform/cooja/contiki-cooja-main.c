@@ -44,6 +44,7 @@
 
 #include "sys/clock.h"
 #include "sys/etimer.h"
+#include "sys/idle.h"
 #include "sys/cooja_mt.h"
 #include "sys/autostart.h"
 
@@ -452,13 +453,15 @@ Java_org_contikios_cooja_corecomm_CLASSNAME_setMemory(JNIEnv *env, jobject obj,
 JNIEXPORT void JNICALL
 Java_org_contikios_cooja_corecomm_CLASSNAME_tick(JNIEnv *env, jobject obj)
 {
+  clock_time_t idle;
+
   simProcessRunValue = 0;
 
   /* Let all simulation interfaces act first */
   doActionsBeforeTick();
 
-  /* Poll etimer process */
-  if(etimer_pending()) {
+  /* Poll etimer process if a timer is due */
+  if(etimer_pending() && etimer_time_to_next_expiration() == 0) {
     etimer_request_poll();
   }
 
@@ -475,11 +478,13 @@ Java_org_contikios_cooja_corecomm_CLASSNAME_tick(JNIEnv *env, jobject obj)
   /* Let all simulation interfaces act before returning to java */
   doActionsAfterTick();
 
-  /* Do we have any pending timers */
-  simEtimerPending = etimer_pending();
-
-  /* Save nearest expiration time */
-  simEtimerNextExpirationTime = etimer_next_expiration_time();
+  /* Save the next deadline of all timers. The simulator wakes the
+     mote up then, or earlier for pending events and rtimers. idle is
+     relative, so it is added to the 64-bit time: clock_time() wraps
+     where clock_time_t is 32 bits wide. */
+  idle = idle_time();
+  simEtimerPending = idle != IDLE_TIME_FOREVER;
+  simEtimerNextExpirationTime = simCurrentTime + idle;
 
 }
 /*---------------------------------------------------------------------------*/
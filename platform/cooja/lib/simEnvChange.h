@@ -42,8 +42,13 @@ struct simInterface {
 // Variable for keeping the last process_run() return value
 extern int simProcessRunValue;
 extern int simEtimerPending;
-extern clock_time_t simEtimerNextExpirationTime;
-extern clock_time_t simCurrentTime;
+/* Clock values shared with the simulator are 64 bits wide on all hosts,
+   so that long simulations do not wrap them. The mote itself still uses
+   clock_time_t, an unsigned long: on 32-bit hosts clock_time() wraps
+   after 2^32 ms (about 49.7 days) of simulated time. Timers handle that
+   wrap like on hardware, only intervals above half that range fail. */
+extern int64_t simEtimerNextExpirationTime;
+extern int64_t simCurrentTime;
 
 // Variable that when set to != 0, stops the mote from falling asleep next tick
 extern char simDontFallAsleep;
@@ -35,7 +35,7 @@
 const struct simInterface clock_interface;
 
 // COOJA variables
-clock_time_t simCurrentTime;
+int64_t simCurrentTime;
 
 /*-----------------------------------------------------------------------------------*/
 void
@@ -46,7 +46,7 @@ clock_init(void)
 clock_time_t
 clock_time(void)
 {
-  return simCurrentTime;
+  return (clock_time_t)simCurrentTime;
 }
 /*-----------------------------------------------------------------------------------*/
 unsigned long
@@ -54,6 +54,7 @@
 
 #include "contiki.h"
 #include "net/netstack.h"
+#include "sys/idle.h"
 
 #include "ctk/ctk.h"
 #include "ctk/ctk-curses.h"
@@ -257,11 +258,21 @@ main(int argc, char **argv)
     int i;
     int retval;
     struct timeval tv;
+    struct timeval *timeout;
+    clock_time_t ticks;
 
-    retval = process_run();
+    process_run();
 
-    tv.tv_sec = 0;
-    tv.tv_usec = retval ? 1 : 1000;
+    /* Sleep until the next timer is due, or until a file descriptor or
+       a signal wakes us up */
+    ticks = idle_time();
+    if(ticks == IDLE_TIME_FOREVER) {
+      timeout = NULL;
+    } else {
+      tv.tv_sec = ticks / CLOCK_SECOND;
+      tv.tv_usec = (ticks % CLOCK_SECOND) * 1000000 / CLOCK_SECOND;
+      timeout = &tv;
+    }
 
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
@@ -272,7 +283,7 @@ main(int argc, char **argv)
       }
     }
 
-    retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
+    retval = select(maxfd + 1, &fdr, &fdw, NULL, timeout);
     if(retval < 0) {
       if(errno != EINTR) {
         perror("select");
@@ -286,7 +297,9 @@ main(int argc, char **argv)
       }
     }
 
-    etimer_request_poll();
+    if(etimer_pending() && etimer_time_to_next_expiration() == 0) {
+      etimer_request_poll();
+    }
 
 #if WITH_GUI
     if(console_resize()) {
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "net/mac/aloha.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+PROCESS(test_process, "aloha neighbor lookup test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Number of neighbors with a packet in flight at the same time */
+#define MAX_NEIGHBORS 16
+/* Rounds per test, each must find the queues emptied by the last one */
+#define ROUNDS 8
+
+/* Transmissions handed to the stub RDC, completed later by the test */
+static struct {
+  mac_callback_t sent;
+  void *ptr;
+  struct rdc_buf_list *list;
+} deferred[MAX_NEIGHBORS];
+static int deferred_count;
+
+/* Upper-layer callbacks, per neighbor */
+static int neighbor_id[MAX_NEIGHBORS];
+static int sent_ok[MAX_NEIGHBORS];
+static int sent_failed[MAX_NEIGHBORS];
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stub_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+stub_send_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *list)
+{
+  if(deferred_count < MAX_NEIGHBORS) {
+    deferred[deferred_count].sent = sent;
+    deferred[deferred_count].ptr = ptr;
+    deferred[deferred_count].list = list;
+    deferred_count++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void stub_init(void) { }
+static void stub_input(void) { }
+static int stub_on(void) { return 1; }
+static int stub_off(int keep_radio_on) { return 1; }
+static unsigned short stub_channel_check_interval(void) { return 0; }
+
+const struct rdc_driver test_rdc_driver = {
+  "test-rdc",
+  stub_init,
+  stub_send,
+  stub_send_list,
+  stub_input,
+  stub_on,
+  stub_off,
+  stub_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+static void
+mac_sent(void *ptr, int status, int transmissions)
+{
+  int i = *(int *)ptr;
+
+  if(status == MAC_TX_OK) {
+    sent_ok[i]++;
+  } else {
+    sent_failed[i]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset_counts(void)
+{
+  int i;
+
+  for(i = 0; i < MAX_NEIGHBORS; i++) {
+    neighbor_id[i] = i;
+    sent_ok[i] = 0;
+    sent_failed[i] = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Queue one packet to each of `count` neighbors. Each neighbor holds a
+   single packet, so a packet that was not freed makes the next send to
+   that neighbor fail. */
+static void
+queue_packets(int count)
+{
+  linkaddr_t addr;
+  int i;
+
+  deferred_count = 0;
+  for(i = 0; i < count; i++) {
+    packetbuf_clear();
+    packetbuf_set_datalen(16);
+    linkaddr_copy(&addr, &linkaddr_null);
+    addr.u8[0] = i + 1;
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+    aloha_driver.send(mac_sent, &neighbor_id[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Complete transmission i of the stub RDC, reporting it on behalf of
+   the neighbor that transmission j was handed to */
+static void
+complete(int i, int j, int status)
+{
+  queuebuf_to_packetbuf(deferred[i].list->buf);
+  deferred[j].sent(deferred[j].ptr, status, 1);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_aloha_callbacks, "Callbacks");
+UNIT_TEST(test_aloha_callbacks)
+{
+  int r, i;
+  int all_ok;
+
+  UNIT_TEST_BEGIN();
+
+  reset_counts();
+  for(r = 0; r < ROUNDS; r++) {
+    queue_packets(MAX_NEIGHBORS);
+    UNIT_TEST_ASSERT(deferred_count == MAX_NEIGHBORS);
+    /* Reverse order, so most lookups pass other queued packets */
+    for(i = deferred_count - 1; i >= 0; i--) {
+      complete(i, i, MAC_TX_OK);
+    }
+  }
+
+  /* Every callback from the RDC was matched to its own packet, and
+     each packet was freed before the next round queued another one */
+  all_ok = 1;
+  for(i = 0; i < MAX_NEIGHBORS; i++) {
+    if(sent_ok[i] != ROUNDS || sent_failed[i] != 0) {
+      all_ok = 0;
+    }
+  }
+  UNIT_TEST_ASSERT(all_ok);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_aloha_owner, "Owner");
+UNIT_TEST(test_aloha_owner)
+{
+  UNIT_TEST_BEGIN();
+
+  reset_counts();
+  queue_packets(2);
+  UNIT_TEST_ASSERT(deferred_count == 2);
+
+  /* A callback for the packet of neighbor 0, reported as if it came
+     from neighbor 1, must not free either packet */
+  complete(0, 1, MAC_TX_OK);
+  complete(1, 0, MAC_TX_OK);
+  UNIT_TEST_ASSERT(sent_ok[0] == 0 && sent_ok[1] == 0);
+
+  /* The matching callbacks still find both packets */
+  complete(0, 0, MAC_TX_OK);
+  complete(1, 1, MAC_TX_OK);
+  UNIT_TEST_ASSERT(sent_ok[0] == 1 && sent_ok[1] == 1);
+  UNIT_TEST_ASSERT(sent_failed[0] == 0 && sent_failed[1] == 0);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  aloha_driver.init();
+
+  UNIT_TEST_RUN(test_aloha_callbacks);
+  UNIT_TEST_RUN(test_aloha_owner);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "dev/radio.h"
+#include "net/mac/csma.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+
+PROCESS(test_process, "csma busy channel test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Channel senses that find the channel busy. Counted as collisions,
+   the default backoffs and retries would drop the packet after 48. */
+#define BUSY_SENSES 100
+/* Longest time a run may take before it counts as lost */
+#define RUN_TIMEOUT (30 * CLOCK_SECOND)
+
+static int busy_left;
+static int senses;
+
+/* Transmission handed to the stub RDC, completed later by the test */
+static mac_callback_t deferred_sent;
+static void *deferred_ptr;
+static struct rdc_buf_list *deferred_list;
+
+static int sent_ok;
+static int sent_failed;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+stub_channel_clear(void)
+{
+  senses++;
+  if(busy_left > 0) {
+    busy_left--;
+    return 0;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int radio_init(void) { return 1; }
+static int radio_prepare(const void *payload, unsigned short len) { return 0; }
+static int radio_transmit(unsigned short len) { return RADIO_TX_OK; }
+static int radio_send(const void *payload, unsigned short len) { return RADIO_TX_OK; }
+static int radio_read(void *buf, unsigned short len) { return 0; }
+static int radio_receiving_packet(void) { return 0; }
+static int radio_pending_packet(void) { return 0; }
+static int radio_on(void) { return 1; }
+static int radio_off(void) { return 1; }
+static radio_result_t
+radio_get_value(radio_param_t param, radio_value_t *value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+static radio_result_t
+radio_set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+
+const struct radio_driver test_radio_driver = {
+  radio_init,
+  radio_prepare,
+  radio_transmit,
+  radio_send,
+  radio_read,
+  stub_channel_clear,
+  radio_receiving_packet,
+  radio_pending_packet,
+  radio_on,
+  radio_off,
+  radio_get_value,
+  radio_set_value,
+  radio_get_object,
+  radio_set_object,
+};
+/*---------------------------------------------------------------------------*/
+static void
+stub_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+stub_send_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *list)
+{
+  deferred_sent = sent;
+  deferred_ptr = ptr;
+  deferred_list = list;
+}
+/*---------------------------------------------------------------------------*/
+static void stub_init(void) { }
+static void stub_input(void) { }
+static int stub_on(void) { return 1; }
+static int stub_off(int keep_radio_on) { return 1; }
+static unsigned short stub_channel_check_interval(void) { return 0; }
+
+const struct rdc_driver test_rdc_driver = {
+  "test-rdc",
+  stub_init,
+  stub_send,
+  stub_send_list,
+  stub_input,
+  stub_on,
+  stub_off,
+  stub_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+static void
+mac_sent(void *ptr, int status, int transmissions)
+{
+  if(status == MAC_TX_OK) {
+    sent_ok++;
+  } else {
+    sent_failed++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Start a run: the channel is busy for the next BUSY_SENSES senses,
+   then one packet is queued through mac */
+static void
+start_run(const struct mac_driver *mac)
+{
+  linkaddr_t addr;
+
+  busy_left = BUSY_SENSES;
+  senses = 0;
+  sent_ok = 0;
+  sent_failed = 0;
+  deferred_sent = NULL;
+
+  mac->init();
+  packetbuf_clear();
+  packetbuf_set_datalen(16);
+  linkaddr_copy(&addr, &linkaddr_null);
+  addr.u8[0] = 1;
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  mac->send(mac_sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* Called once the run reached the RDC, failed or timed out */
+static void
+finish_run(void)
+{
+  if(deferred_sent != NULL) {
+    queuebuf_to_packetbuf(deferred_list->buf);
+    deferred_sent(deferred_ptr, MAC_TX_OK, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_ppersistent, "p-persistent busy channel");
+UNIT_TEST(test_ppersistent)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The packet waited out the busy channel and was sent once */
+  UNIT_TEST_ASSERT(sent_failed == 0);
+  UNIT_TEST_ASSERT(sent_ok == 1);
+  UNIT_TEST_ASSERT(senses > BUSY_SENSES);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_nonpersistent, "non-persistent busy channel");
+UNIT_TEST(test_nonpersistent)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(sent_failed == 0);
+  UNIT_TEST_ASSERT(sent_ok == 1);
+  UNIT_TEST_ASSERT(senses > BUSY_SENSES);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  static struct timer timeout;
+
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* Transmit as soon as the channel is clear */
+  csma_set_persistence(CSMA_PERSISTENCE_SCALE);
+  start_run(&csma_ppersistent_driver);
+  timer_set(&timeout, RUN_TIMEOUT);
+  while(deferred_sent == NULL && sent_failed == 0 && !timer_expired(&timeout)) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+  finish_run();
+  UNIT_TEST_RUN(test_ppersistent);
+
+  start_run(&csma_nonpersistent_driver);
+  timer_set(&timeout, RUN_TIMEOUT);
+  while(deferred_sent == NULL && sent_failed == 0 && !timer_expired(&timeout)) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+  finish_run();
+  UNIT_TEST_RUN(test_nonpersistent);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
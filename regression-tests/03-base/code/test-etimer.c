@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "lib/random.h"
+
+PROCESS(test_process, "etimer test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Timers set, reset, stopped and adjusted at random */
+#define TIMERS 16
+#define MAX_INTERVAL 20
+/* Each seed runs STEPS clock ticks with a few operations per tick */
+#define SEEDS 8
+#define STEPS 2500
+
+static struct etimer et[TIMERS];
+/* Pending and expired at the end of the previous tick: it must have
+   been fired since */
+static uint8_t due[TIMERS];
+/* Wakes the test once per tick */
+static struct etimer tick;
+
+static unsigned long late;
+static unsigned long early;
+static unsigned long wakeup;
+static unsigned long near_resets;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+left(struct etimer *t)
+{
+  return timer_expired(&t->timer) ? 0 : timer_remaining(&t->timer);
+}
+/*---------------------------------------------------------------------------*/
+static void
+check(void)
+{
+  clock_time_t next;
+  int i;
+
+  next = etimer_time_to_next_expiration();
+  for(i = 0; i < TIMERS; i++) {
+    if(etimer_expired(&et[i])) {
+      continue;
+    }
+    if(due[i]) {
+      late++;
+    }
+    /* The next wakeup must not be after any pending timer */
+    if(next > left(&et[i])) {
+      wakeup++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+step(void)
+{
+  int n, i;
+
+  for(n = random_rand() % 4; n > 0; n--) {
+    i = random_rand() % TIMERS;
+    switch(random_rand() % 6) {
+    case 0:
+    case 1:
+      etimer_set(&et[i], 1 + random_rand() % MAX_INTERVAL);
+      break;
+    case 2:
+      etimer_reset(&et[i]);
+      break;
+    case 3:
+      etimer_restart(&et[i]);
+      break;
+    case 4:
+      etimer_stop(&et[i]);
+      break;
+    default:
+      etimer_adjust(&et[i], (int)(random_rand() % 5) - 2);
+      break;
+    }
+  }
+
+  /* A periodic timer reset one tick before it expires starts one tick
+     in the future */
+  for(i = 0; i < TIMERS; i++) {
+    if(!etimer_expired(&et[i]) && left(&et[i]) == 1 &&
+       random_rand() % 2) {
+      etimer_reset(&et[i]);
+      near_resets++;
+    }
+  }
+
+  for(i = 0; i < TIMERS; i++) {
+    due[i] = !etimer_expired(&et[i]) && timer_expired(&et[i].timer);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+stop_all(void)
+{
+  int i;
+
+  for(i = 0; i < TIMERS; i++) {
+    etimer_stop(&et[i]);
+    due[i] = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_etimer_random, "Random");
+UNIT_TEST(test_etimer_random)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(near_resets > 0);
+  UNIT_TEST_ASSERT(late == 0);
+  UNIT_TEST_ASSERT(early == 0);
+  UNIT_TEST_ASSERT(wakeup == 0);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  static unsigned seed;
+  static unsigned long steps;
+  int i;
+
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(seed = 1; seed <= SEEDS; seed++) {
+    random_init(seed);
+    stop_all();
+    etimer_set(&tick, 1);
+    steps = 0;
+    while(steps < STEPS) {
+      PROCESS_WAIT_EVENT();
+      if(ev == PROCESS_EVENT_TIMER && data == &tick) {
+        /* Timers that expired along with the tick may still have their
+           events queued: go on once they have been delivered */
+        process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+      } else if(ev == PROCESS_EVENT_TIMER) {
+        for(i = 0; i < TIMERS; i++) {
+          if(data == &et[i] && !timer_expired(&et[i].timer)) {
+            early++;
+          }
+        }
+      } else if(ev == PROCESS_EVENT_CONTINUE) {
+        check();
+        step();
+        steps++;
+        etimer_set(&tick, 1);
+      }
+    }
+  }
+  stop_all();
+  etimer_stop(&tick);
+
+  UNIT_TEST_RUN(test_etimer_random);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, Contiki contributors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "lib/mmem.h"
+#include "lib/random.h"
+
+PROCESS(test_process, "mmem test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Random allocations, frees and compactions in the randomized test */
+#define OPS 2000000UL
+/* Handles used at the same time */
+#define BLOCKS 80
+/* Largest block; one in four allocations may be up to this size, the
+   others are below 64 bytes */
+#define MAX_BLOCK 600
+
+static struct mmem m[BLOCKS];
+static unsigned short len[BLOCKS];
+static uint8_t tag[BLOCKS];
+static uint8_t live[BLOCKS];
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(int i)
+{
+  uint8_t *p = (uint8_t *)MMEM_PTR(&m[i]);
+  unsigned short j;
+
+  for(j = 0; j < len[i]; j++) {
+    p[j] = tag[i] + j;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Every live block must be aligned and hold what was written to it,
+   wherever compaction moved it */
+static int
+blocks_intact(void)
+{
+  uint8_t *p;
+  unsigned short j;
+  int i;
+
+  for(i = 0; i < BLOCKS; i++) {
+    if(!live[i]) {
+      continue;
+    }
+    p = (uint8_t *)MMEM_PTR(&m[i]);
+    if((uintptr_t)p % sizeof(void *) != 0) {
+      return 0;
+    }
+    for(j = 0; j < len[i]; j++) {
+      if(p[j] != (uint8_t)(tag[i] + j)) {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+stats_consistent(void)
+{
+  struct mmem_stats st;
+  unsigned long payload;
+  int i;
+
+  payload = 0;
+  for(i = 0; i < BLOCKS; i++) {
+    if(live[i]) {
+      payload += len[i];
+    }
+  }
+  mmem_stats(&st);
+  return st.used >= payload && st.used <= st.size &&
+    st.peak >= st.used &&
+    st.largest_free <= st.size - st.used &&
+    st.free_blocks <= st.size - st.used;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_mmem_random, "Random");
+UNIT_TEST(test_mmem_random)
+{
+  unsigned long k;
+  unsigned short size;
+  int op, i;
+  int ok;
+
+  UNIT_TEST_BEGIN();
+
+  random_init(1);
+  mmem_init();
+  ok = 1;
+  for(k = 0; k < OPS && ok; k++) {
+    op = random_rand() % 10;
+    i = random_rand() % BLOCKS;
+    if(op < 5) {
+      if(!live[i]) {
+        size = random_rand() % 4 ? random_rand() % 64 :
+          random_rand() % MAX_BLOCK;
+        if(mmem_alloc(&m[i], size)) {
+          live[i] = 1;
+          len[i] = size;
+          tag[i] = random_rand();
+          fill(i);
+        } else if(MMEM_PTR(&m[i]) != NULL) {
+          /* A failed allocation leaves no dangling pointer */
+          ok = 0;
+        }
+      }
+    } else if(op < 9) {
+      if(live[i]) {
+        mmem_free(&m[i]);
+        live[i] = 0;
+      }
+    } else {
+      mmem_compact(random_rand() % 200);
+    }
+    /* Compaction, also from mmem_alloc(), moves blocks under their
+       owners: check them all once in a while and after every explicit
+       compaction */
+    if(op == 9 || k % 97 == 0) {
+      ok = blocks_intact() && stats_consistent();
+    }
+  }
+  UNIT_TEST_ASSERT(ok);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_mmem_free_all, "FreeAll");
+UNIT_TEST(test_mmem_free_all)
+{
+  struct mmem_stats st;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < BLOCKS; i++) {
+    if(live[i]) {
+      mmem_free(&m[i]);
+      live[i] = 0;
+    }
+  }
+  mmem_stats(&st);
+  /* An empty arena is whole again, without compaction */
+  UNIT_TEST_ASSERT(st.used == 0);
+  UNIT_TEST_ASSERT(st.largest_free == st.size);
+  UNIT_TEST_ASSERT(st.free_blocks == 0);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(test_mmem_random);
+  UNIT_TEST_RUN(test_mmem_free_all);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
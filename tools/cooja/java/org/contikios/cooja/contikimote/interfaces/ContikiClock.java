@@ -51,15 +51,26 @@ import org.contikios.cooja.mote.memory.VarMemory;
  *
  * Contiki variables:
  * <ul>
- * <li>clock_time_t simCurrentTime
+ * <li>int64_t simCurrentTime
  * <li>rtimer_clock_t simRtimerCurrentTicks
- * <li>clock_time_t simEtimerNextExpirationTime
- * <li>rtimer_clock_t simEtimerNextExpirationTime
- * <li>int simEtimerProcessRunValue
- * <li>int simRtimerProcessRunValue
+ * <li>int64_t simEtimerNextExpirationTime
+ * <li>rtimer_clock_t simRtimerNextExpirationTime
+ * <li>int simProcessRunValue
+ * <li>int simRtimerPending
  * <li>int simEtimerPending
  * </ul>
  *
+ * After every tick the mote is scheduled to wake up at the earliest of its
+ * next rtimer, its next deadline from idle_time() (etimers, ctimers and,
+ * rounded to milliseconds, rtimers) and, if events are pending, the next
+ * millisecond. An idle mote is not ticked in between, the simulation jumps
+ * directly to the next mote that has something to do.
+ *
+ * simCurrentTime and simEtimerNextExpirationTime are 64 bits wide on all
+ * hosts. Inside the mote, clock_time() returns the low bits as
+ * clock_time_t (unsigned long), which wraps after about 49.7 days of
+ * simulated time on 32-bit hosts.
+ *
  * Core interface:
  * <ul>
  * <li>clock_interface
@@ -101,7 +112,7 @@ public class ContikiClock extends Clock implements ContikiMoteInterface, PolledB
   public void setTime(long newTime) {
     moteTime = newTime;
     if (moteTime > 0) {
-      moteMem.setIntValueOf("simCurrentTime", (int)(newTime/1000));
+      moteMem.setInt64ValueOf("simCurrentTime", newTime/1000);
     }
   }
 
@@ -135,40 +146,38 @@ public class ContikiClock extends Clock implements ContikiMoteInterface, PolledB
 
   public void doActionsAfterTick() {
     long currentSimulationTime = mote.getSimulation().getSimulationTime();
+    long nextWakeup = Long.MAX_VALUE;
 
     /* Always schedule for Rtimer if anything pending */
     if (moteMem.getIntValueOf("simRtimerPending") != 0) {
-      mote.scheduleNextWakeup(moteMem.getInt64ValueOf("simRtimerNextExpirationTime"));
+      nextWakeup = moteMem.getInt64ValueOf("simRtimerNextExpirationTime");
     }
 
-    /* Request next tick for remaining events / timers */
     int processRunValue = moteMem.getIntValueOf("simProcessRunValue");
     if (processRunValue != 0) {
       /* Handle next Contiki event in one millisecond */
-      mote.scheduleNextWakeup(currentSimulationTime + Simulation.MILLISECOND);
-      return;
+      nextWakeup = Math.min(nextWakeup, currentSimulationTime + Simulation.MILLISECOND);
+    } else if (moteMem.getIntValueOf("simEtimerPending") != 0) {
+      /* Request tick next wakeup time for Etimer */
+      long etimerNextExpirationTime = moteMem.getInt64ValueOf("simEtimerNextExpirationTime") * Simulation.MILLISECOND;
+      long etimerTimeToNextExpiration = etimerNextExpirationTime - moteTime;
+      if (etimerTimeToNextExpiration <= 0) {
+        /* logger.warn(mote.getID() + ": Event timer already expired, but has been delayed: " + etimerTimeToNextExpiration); */
+        /* Wake up in one millisecond to handle a missed Etimer task
+         * which may be blocked by busy waiting such as one in
+         * radio_send(). Scheduling it in a shorter time than one
+         * millisecond, e.g., one microsecond, seems to be worthless and
+         * it would cause unnecessary CPU usage. */
+        etimerTimeToNextExpiration = Simulation.MILLISECOND;
+      }
+      nextWakeup = Math.min(nextWakeup, currentSimulationTime + etimerTimeToNextExpiration);
     }
 
-    int etimersPending = moteMem.getIntValueOf("simEtimerPending");
-    if (etimersPending == 0) {
-      /* No timers */
+    if (nextWakeup == Long.MAX_VALUE) {
+      /* Idle until an interface, e.g. the radio, wakes the mote up */
       return;
     }
-
-    /* Request tick next wakeup time for Etimer */
-    long etimerNextExpirationTime = (long)moteMem.getInt32ValueOf("simEtimerNextExpirationTime") * Simulation.MILLISECOND;
-    long etimerTimeToNextExpiration = etimerNextExpirationTime - moteTime;
-    if (etimerTimeToNextExpiration <= 0) {
-      /* logger.warn(mote.getID() + ": Event timer already expired, but has been delayed: " + etimerTimeToNextExpiration); */
-      /* Wake up in one millisecond to handle a missed Etimer task
-       * which may be blocked by busy waiting such as one in
-       * radio_send(). Scheduling it in a shorter time than one
-       * millisecond, e.g., one microsecond, seems to be worthless and
-       * it would cause unnecessary CPU usage. */
-      mote.scheduleNextWakeup(currentSimulationTime + Simulation.MILLISECOND);
-    } else {
-      mote.scheduleNextWakeup(currentSimulationTime + etimerTimeToNextExpiration);
-    }
+    mote.scheduleNextWakeup(nextWakeup);
   }
 
 
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026, Contiki contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer. 2. Redistributions in
+ * binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution. 3. Neither the name of the
+ * copyright holder nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+ * IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+package org.contikios.cooja.radiomediums;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.ThreadFactory;
+
+import org.apache.log4j.Logger;
+
+import org.contikios.cooja.interfaces.Position;
+import org.contikios.cooja.interfaces.Radio;
+
+/**
+ * Uniform grid over the positions of a set of radios, for finding all radios
+ * within a fixed range of each other without comparing every pair.
+ *
+ * The grid is a snapshot: it copies the positions when created and must be
+ * rebuilt when radios move. Queries return radios in the order they were
+ * given to the constructor, and distances are computed exactly like
+ * {@link Position#getDistanceTo(Position)}, so a radio medium using the grid
+ * sees the same neighbors, in the same order, as one comparing all pairs.
+ *
+ * Neighbor lists of all radios can be computed in parallel with
+ * {@link #getAllNeighbors()}. This only reads the snapshot, never the radios,
+ * and the result does not depend on the number of threads, which defaults
+ * to the number of cores and can be set with the system property
+ * cooja.radiomedium.threads.
+ *
+ * @see UDGM
+ */
+public class RadioGrid {
+  private static Logger logger = Logger.getLogger(RadioGrid.class);
+
+  /* Below this many radios, all neighbor lists are computed by the caller */
+  private static final int PARALLEL_THRESHOLD = 64;
+
+  private static ExecutorService executor = null;
+  private static int threads = Integer.getInteger("cooja.radiomedium.threads",
+      Runtime.getRuntime().availableProcessors());
+
+  private final double range;
+  private final double[] x, y, z;
+  private final long[] cellOf;
+  private final HashMap<Long, int[]> cells = new HashMap<Long, int[]>();
+  private final boolean singleCell;
+
+  /**
+   * @param radios Radios, the index of a radio in this array is used in all
+   *               queries
+   * @param range Neighbor range. Radios strictly closer than range are
+   *               neighbors.
+   */
+  public RadioGrid(Radio[] radios, double range) {
+    this.range = range;
+    int n = radios.length;
+    x = new double[n];
+    y = new double[n];
+    z = new double[n];
+    cellOf = new long[n];
+
+    for (int i = 0; i < n; i++) {
+      Position pos = radios[i].getPosition();
+      x[i] = pos.getXCoordinate();
+      y[i] = pos.getYCoordinate();
+      z[i] = pos.getZCoordinate();
+    }
+
+    /* Infinite or huge ranges, or odd coordinates: one cell holds everyone */
+    boolean single = !(range > 0) || Double.isInfinite(range);
+    for (int i = 0; i < n && !single; i++) {
+      single = !isCellCoordinate(x[i]) || !isCellCoordinate(y[i]) || !isCellCoordinate(z[i]);
+    }
+    singleCell = single;
+
+    /* Bucket radios by cell, keeping them sorted by index */
+    HashMap<Long, ArrayList<Integer>> lists = new HashMap<Long, ArrayList<Integer>>();
+    for (int i = 0; i < n; i++) {
+      cellOf[i] = singleCell ? 0 : key(cell(x[i]), cell(y[i]), cell(z[i]));
+      ArrayList<Integer> list = lists.get(cellOf[i]);
+      if (list == null) {
+        list = new ArrayList<Integer>();
+        lists.put(cellOf[i], list);
+      }
+      list.add(i);
+    }
+    for (Long k : lists.keySet()) {
+      ArrayList<Integer> list = lists.get(k);
+      int[] arr = new int[list.size()];
+      for (int i = 0; i < arr.length; i++) {
+        arr[i] = list.get(i);
+      }
+      cells.put(k, arr);
+    }
+  }
+
+  /* Cell coordinates must fit the 21 bits per axis of a cell key */
+  private boolean isCellCoordinate(double c) {
+    double cc = Math.floor(c / range);
+    return !Double.isNaN(cc) && Math.abs(cc) < (1 << 20) - 1;
+  }
+
+  private long cell(double c) {
+    return (long) Math.floor(c / range);
+  }
+
+  private static long key(long cx, long cy, long cz) {
+    final long mask = (1L << 21) - 1;
+    return ((cx & mask) << 42) | ((cy & mask) << 21) | (cz & mask);
+  }
+
+  /**
+   * Same computation as Position.getDistanceTo(), from radio i to radio j.
+   */
+  public double getDistance(int i, int j) {
+    return Math.sqrt(Math.abs(x[i] - x[j])
+        * Math.abs(x[i] - x[j])
+        + Math.abs(y[i] - y[j])
+        * Math.abs(y[i] - y[j])
+        + Math.abs(z[i] - z[j])
+        * Math.abs(z[i] - z[j]));
+  }
+
+  /**
+   * @param i Radio index
+   * @return Indices of all other radios closer than the range, ascending
+   */
+  public int[] getNeighbors(int i) {
+    int[] found = new int[16];
+    int count = 0;
+
+    if (singleCell) {
+      for (int j : cells.get(0L)) {
+        if (j != i && getDistance(i, j) < range) {
+          if (count == found.length) {
+            found = Arrays.copyOf(found, count * 2);
+          }
+          found[count++] = j;
+        }
+      }
+      return Arrays.copyOf(found, count);
+    }
+
+    long cx = cell(x[i]), cy = cell(y[i]), cz = cell(z[i]);
+    for (long dx = -1; dx <= 1; dx++) {
+      for (long dy = -1; dy <= 1; dy++) {
+        for (long dz = -1; dz <= 1; dz++) {
+          int[] members = cells.get(key(cx + dx, cy + dy, cz + dz));
+          if (members == null) {
+            continue;
+          }
+          for (int j : members) {
+            if (j != i && getDistance(i, j) < range) {
+              if (count == found.length) {
+                found = Arrays.copyOf(found, count * 2);
+              }
+              found[count++] = j;
+            }
+          }
+        }
+      }
+    }
+
+    /* Cells are visited in no particular order */
+    int[] result = Arrays.copyOf(found, count);
+    Arrays.sort(result);
+    return result;
+  }
+
+  /**
+   * Neighbors of every radio, computed on all cores for large networks.
+   *
+   * @return Element i holds getNeighbors(i)
+   */
+  public int[][] getAllNeighbors() {
+    final int n = x.length;
+    final int[][] neighbors = new int[n][];
+
+    ExecutorService pool = getExecutor();
+    if (n < PARALLEL_THRESHOLD || pool == null) {
+      for (int i = 0; i < n; i++) {
+        neighbors[i] = getNeighbors(i);
+      }
+      return neighbors;
+    }
+
+    /* Each task fills its own slice, the result is independent of the
+     * scheduling */
+    int chunk = (n + threads - 1) / threads;
+    List<Future<?>> tasks = new ArrayList<Future<?>>();
+    for (int start = 0; start < n; start += chunk) {
+      final int from = start;
+      final int to = Math.min(start + chunk, n);
+      tasks.add(pool.submit(new Runnable() {
+        public void run() {
+          for (int i = from; i < to; i++) {
+            neighbors[i] = getNeighbors(i);
+          }
+        }
+      }));
+    }
+    for (Future<?> task : tasks) {
+      try {
+        task.get();
+      } catch (InterruptedException e) {
+        Thread.currentThread().interrupt();
+        throw new RuntimeException(e);
+      } catch (ExecutionException e) {
+        throw new RuntimeException(e.getCause());
+      }
+    }
+    return neighbors;
+  }
+
+  /**
+   * Sets the number of threads used by all grids. 1 disables parallel
+   * evaluation.
+   */
+  public static synchronized void setThreads(int n) {
+    if (executor != null) {
+      executor.shutdown();
+      executor = null;
+    }
+    threads = Math.max(n, 1);
+  }
+
+  private static synchronized ExecutorService getExecutor() {
+    if (threads <= 1) {
+      return null;
+    }
+    if (executor == null) {
+      executor = Executors.newFixedThreadPool(threads, new ThreadFactory() {
+        private int count = 0;
+        public Thread newThread(Runnable r) {
+          Thread t = new Thread(r, "radio medium " + (count++));
+          t.setDaemon(true);
+          return t;
+        }
+      });
+      logger.debug("Radio medium evaluation on " + threads + " threads");
+    }
+    return executor;
+  }
+}
@@ -44,7 +44,6 @@ import org.contikios.cooja.Mote;
 import org.contikios.cooja.RadioConnection;
 import org.contikios.cooja.SimEventCentral.MoteCountListener;
 import org.contikios.cooja.Simulation;
-import org.contikios.cooja.interfaces.Position;
 import org.contikios.cooja.interfaces.Radio;
 import org.contikios.cooja.plugins.Visualizer;
 import org.contikios.cooja.plugins.skins.UDGMVisualizerSkin;
@@ -96,24 +95,21 @@ public class UDGM extends AbstractRadioMedium {
     random = simulation.getRandomGenerator();
     dgrm = new DirectedGraphMedium() {
       protected void analyzeEdges() {
-        /* Create edges according to distances.
+        /* Create edges according to distances, looking only at nearby
+         * radios. Edges are added in the same order as when comparing all
+         * pairs of radios.
          * XXX May be slow for mobile networks */
         clearEdges();
-        for (Radio source: UDGM.this.getRegisteredRadios()) {
-          Position sourcePos = source.getPosition();
-          for (Radio dest: UDGM.this.getRegisteredRadios()) {
-            Position destPos = dest.getPosition();
-            /* Ignore ourselves */
-            if (source == dest) {
-              continue;
-            }
-            double distance = sourcePos.getDistanceTo(destPos);
-            if (distance < Math.max(TRANSMITTING_RANGE, INTERFERENCE_RANGE)) {
-              /* Add potential destination */
-              addEdge(
-                  new DirectedGraphMedium.Edge(source, 
-                      new DGRMDestinationRadio(dest)));
-            }
+        Radio[] radios = UDGM.this.getRegisteredRadios();
+        RadioGrid grid = new RadioGrid(radios,
+            Math.max(TRANSMITTING_RANGE, INTERFERENCE_RANGE));
+        int[][] neighbors = grid.getAllNeighbors();
+        for (int i = 0; i < radios.length; i++) {
+          for (int j : neighbors[i]) {
+            /* Add potential destination */
+            addEdge(
+                new DirectedGraphMedium.Edge(radios[i],
+                    new UDGMDestinationRadio(radios[j], grid.getDistance(i, j))));
           }
         }
         super.analyzeEdges();
@@ -163,6 +159,19 @@ public class UDGM extends AbstractRadioMedium {
     dgrm.requestEdgeAnalysis();
   }
 
+  /**
+   * Potential destination, with its distance to the source when the
+   * edges were last analyzed.
+   */
+  private static class UDGMDestinationRadio extends DGRMDestinationRadio {
+    final double distance;
+
+    UDGMDestinationRadio(Radio dest, double distance) {
+      super(dest);
+      this.distance = distance;
+    }
+  }
+
   public RadioConnection createConnections(Radio sender) {
     RadioConnection newConnection = new RadioConnection(sender);
 
@@ -184,7 +193,6 @@ public class UDGM extends AbstractRadioMedium {
     }
 
     /* Loop through all potential destinations */
-    Position senderPos = sender.getPosition();
     for (DestinationRadio dest: potentialDestinations) {
       Radio recv = dest.radio;
 
@@ -201,8 +209,6 @@ public class UDGM extends AbstractRadioMedium {
 
         continue;
       }
-      Position recvPos = recv.getPosition();
-
       /* Fail if radio is turned off */
 //      if (!recv.isReceiverOn()) {
 //        /* Special case: allow connection if source is Contiki radio, 
@@ -217,7 +223,8 @@ public class UDGM extends AbstractRadioMedium {
 //        }
 //      }
 
-      double distance = senderPos.getDistanceTo(recvPos);
+      /* Positions are unchanged since the edges were analyzed */
+      double distance = ((UDGMDestinationRadio) dest).distance;
       if (distance <= moteTransmissionRange) {
         /* Within transmission range */
 
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2026, Contiki contributors. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer. 2. Redistributions in
+ * binary form must reproduce the above copyright notice, this list of
+ * conditions and the following disclaimer in the documentation and/or other
+ * materials provided with the distribution. 3. Neither the name of the
+ * Institute nor the names of its contributors may be used to endorse or promote
+ * products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+package org.contikios.cooja.util;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.FileReader;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.io.PrintWriter;
+import java.io.StringReader;
+import java.net.URISyntaxException;
+import java.nio.file.Files;
+import java.nio.file.StandardCopyOption;
+import java.security.AccessControlException;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Properties;
+import java.util.Random;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import org.apache.log4j.BasicConfigurator;
+import org.apache.log4j.Logger;
+import org.apache.log4j.xml.DOMConfigurator;
+import org.jdom.Document;
+import org.jdom.Element;
+import org.jdom.JDOMException;
+import org.jdom.input.SAXBuilder;
+import org.jdom.output.Format;
+import org.jdom.output.XMLOutputter;
+
+import org.contikios.cooja.Cooja;
+
+/**
+ * Runs a parameter sweep of a simulation without GUI.
+ *
+ * The sweep is described by a properties file:
+ * <pre>
+ * template   = simulation.csc          (required, relative to the sweep file)
+ * duration   = 600                     (simulated seconds per run)
+ * seeds      = 1 2 3                   (one run per random seed)
+ * motes      = 3 10 20                 (optional, number of motes)
+ * param.MAC  = aloha_driver csma_driver
+ * param.CCA  = 216 455
+ * make_args  = DEFINES=NETSTACK_MAC=${MAC},ALOHA_RDC_CCA_ACTIVE_TIME=${CCA}
+ * filter     = ^recv: (\d+),(\d+)      (optional, lines of mote output to keep)
+ * columns    = a,b                     (names of the filter groups)
+ * </pre>
+ *
+ * One run is made for every combination of param.* values, motes and seeds.
+ * ${NAME} is replaced by the value of param.NAME in the template and in
+ * make_args, which is appended to every make command of the template's
+ * mote types. Firmware is built once per distinct command, one build at a
+ * time, into a private object directory. With motes, the first motes of
+ * the template are kept, or the last one is cloned at random positions
+ * inside the template's area.
+ *
+ * The runs are started as separate -nogui Cooja processes, several in
+ * parallel, each in its own directory. The output of all motes is then
+ * merged into a single CSV file, one row per matching output line, with
+ * the parameters of the run as leading columns.
+ *
+ * Only mote types with a firmware element (MSPSim motes) are rebuilt. Cooja
+ * motes compile themselves when loaded and should use one build
+ * configuration per sweep.
+ */
+public class BatchRunner {
+  private static Logger logger = Logger.getLogger(BatchRunner.class);
+
+  public final static String RESULTS_FILENAME = "results.csv";
+  public final static String SIMCONFIG_FILENAME = "simulation.csc";
+  public final static String COOJA_LOG_FILENAME = "cooja.log";
+  public final static String TEST_LOG_FILENAME = "COOJA.testlog";
+
+  private final static Pattern PARAMETER = Pattern.compile("\\$\\{(\\w+)\\}");
+
+  private static class Run {
+    int index;
+    LinkedHashMap<String, String> params;
+    int motes;
+    long seed;
+    File dir;
+    int exitValue = -1;
+  }
+
+  private final File sweepFile;
+  private final File contikiDir;
+  private final File coojaJar;
+  private final File outputDir;
+  private final int jobs;
+
+  private final Properties sweep = new Properties();
+  private final LinkedHashMap<String, String[]> params =
+    new LinkedHashMap<String, String[]>();
+  private final Map<String, File> firmwares = new HashMap<String, File>();
+
+  public BatchRunner(File sweepFile, File contikiDir, File coojaJar,
+      File outputDir, int jobs) {
+    this.sweepFile = sweepFile;
+    this.contikiDir = contikiDir;
+    this.coojaJar = coojaJar;
+    this.outputDir = outputDir;
+    this.jobs = jobs;
+  }
+
+  public static void main(String[] args) {
+    try {
+      if ((new File(Cooja.LOG_CONFIG_FILE)).exists()) {
+        DOMConfigurator.configure(Cooja.LOG_CONFIG_FILE);
+      } else {
+        DOMConfigurator.configure(Cooja.class.getResource("/" + Cooja.LOG_CONFIG_FILE));
+      }
+    } catch (AccessControlException e) {
+      BasicConfigurator.configure();
+    }
+
+    File sweepFile = null;
+    File coojaJar = findCoojaJar();
+    File contikiDir = null;
+    File outputDir = null;
+    int jobs = Runtime.getRuntime().availableProcessors();
+
+    for (String arg : args) {
+      if (arg.startsWith("-contiki=")) {
+        contikiDir = new File(arg.substring("-contiki=".length()));
+      } else if (arg.startsWith("-cooja=")) {
+        coojaJar = new File(arg.substring("-cooja=".length()));
+      } else if (arg.startsWith("-out=")) {
+        outputDir = new File(arg.substring("-out=".length()));
+      } else if (arg.startsWith("-jobs=")) {
+        jobs = Integer.parseInt(arg.substring("-jobs=".length()));
+      } else if (!arg.startsWith("-") && sweepFile == null) {
+        sweepFile = new File(arg);
+      } else {
+        sweepFile = null;
+        break;
+      }
+    }
+
+    if (sweepFile == null || coojaJar == null) {
+      System.err.println(
+          "Usage: BatchRunner [-contiki=DIR] [-cooja=JAR] [-out=DIR] [-jobs=N] SWEEPFILE");
+      System.exit(1);
+    }
+    if (contikiDir == null) {
+      /* cooja.jar is in tools/cooja/dist */
+      contikiDir = coojaJar.getAbsoluteFile().getParentFile().getParentFile()
+        .getParentFile().getParentFile();
+    }
+    if (outputDir == null) {
+      String name = sweepFile.getName();
+      if (name.contains(".")) {
+        name = name.substring(0, name.lastIndexOf('.'));
+      }
+      outputDir = new File(sweepFile.getAbsoluteFile().getParentFile(), name + "-out");
+    }
+
+    try {
+      BatchRunner runner = new BatchRunner(sweepFile, contikiDir, coojaJar,
+          outputDir, Math.max(jobs, 1));
+      System.exit(runner.run() ? 0 : 1);
+    } catch (Exception e) {
+      logger.fatal("Sweep failed: " + e.getMessage(), e);
+      System.exit(1);
+    }
+  }
+
+  private static File findCoojaJar() {
+    try {
+      File f = new File(BatchRunner.class.getProtectionDomain()
+          .getCodeSource().getLocation().toURI());
+      if (f.getName().endsWith(".jar")) {
+        return f;
+      }
+    } catch (URISyntaxException e) {
+    } catch (SecurityException e) {
+    }
+    return null;
+  }
+
+  /**
+   * Runs the whole sweep.
+   *
+   * @return True if every simulation completed
+   */
+  public boolean run() throws IOException, JDOMException, InterruptedException {
+    FileInputStream in = new FileInputStream(sweepFile);
+    try {
+      sweep.load(in);
+    } finally {
+      in.close();
+    }
+    for (String key : sweep.stringPropertyNames()) {
+      if (key.startsWith("param.")) {
+        params.put(key.substring("param.".length()), split(sweep.getProperty(key)));
+      }
+    }
+
+    File template = new File(sweepFile.getAbsoluteFile().getParentFile(),
+        property("template", null));
+    if (!template.exists()) {
+      throw new IOException("Template not found: " + template);
+    }
+    String templateText = new String(Files.readAllBytes(template.toPath()), "UTF-8");
+
+    List<Run> runs = expand();
+    logger.info("Sweep of " + runs.size() + " runs, " + jobs + " in parallel, output in " + outputDir);
+    outputDir.mkdirs();
+
+    /* Prepare every run first, builds are not run in parallel */
+    for (Run run : runs) {
+      prepare(run, template, templateText);
+    }
+
+    ExecutorService executor = Executors.newFixedThreadPool(jobs);
+    List<Future<?>> futures = new ArrayList<Future<?>>();
+    for (final Run run : runs) {
+      futures.add(executor.submit(new Runnable() {
+        public void run() {
+          simulate(run);
+        }
+      }));
+    }
+    executor.shutdown();
+    for (Future<?> f : futures) {
+      try {
+        f.get();
+      } catch (Exception e) {
+        logger.error("Run failed: " + e.getMessage(), e);
+      }
+    }
+
+    return merge(runs);
+  }
+
+  private String property(String key, String def) throws IOException {
+    String value = sweep.getProperty(key, def);
+    if (value == null) {
+      throw new IOException("Missing " + key + " in " + sweepFile);
+    }
+    return value.trim();
+  }
+
+  private static String[] split(String list) {
+    String trimmed = list.trim();
+    if (trimmed.isEmpty()) {
+      return new String[0];
+    }
+    return trimmed.split("[\\s,]+");
+  }
+
+  /* Cartesian product of the parameters, mote counts and seeds */
+  private List<Run> expand() throws IOException {
+    List<LinkedHashMap<String, String>> combinations =
+      new ArrayList<LinkedHashMap<String, String>>();
+    combinations.add(new LinkedHashMap<String, String>());
+    for (Map.Entry<String, String[]> param : params.entrySet()) {
+      List<LinkedHashMap<String, String>> next =
+        new ArrayList<LinkedHashMap<String, String>>();
+      for (LinkedHashMap<String, String> c : combinations) {
+        for (String value : param.getValue()) {
+          LinkedHashMap<String, String> n = new LinkedHashMap<String, String>(c);
+          n.put(param.getKey(), value);
+          next.add(n);
+        }
+      }
+      combinations = next;
+    }
+
+    String[] motes = split(property("motes", "0"));
+    String[] seeds = split(property("seeds", "1"));
+    List<Run> runs = new ArrayList<Run>();
+    for (LinkedHashMap<String, String> c : combinations) {
+      for (String m : motes) {
+        for (String s : seeds) {
+          Run run = new Run();
+          run.index = runs.size();
+          run.params = c;
+          run.motes = Integer.parseInt(m);
+          run.seed = Long.parseLong(s);
+          run.dir = new File(outputDir, "run-" + run.index);
+          runs.add(run);
+        }
+      }
+    }
+    return runs;
+  }
+
+  private static String substitute(String text, Map<String, String> values) {
+    Matcher m = PARAMETER.matcher(text);
+    StringBuffer sb = new StringBuffer();
+    while (m.find()) {
+      String value = values.get(m.group(1));
+      m.appendReplacement(sb, Matcher.quoteReplacement(value != null ? value : m.group()));
+    }
+    m.appendTail(sb);
+    return sb.toString();
+  }
+
+  private String resolvePath(String path, File template) {
+    return path
+      .replace("[CONTIKI_DIR]", contikiDir.getAbsolutePath())
+      .replace("[CONFIG_DIR]", template.getAbsoluteFile().getParent());
+  }
+
+  /* Writes the simulation config of a run, building its firmware */
+  private void prepare(Run run, File template, String templateText)
+  throws IOException, JDOMException, InterruptedException {
+    Document doc = new SAXBuilder().build(
+        new StringReader(substitute(templateText, run.params)));
+    Element simulation = doc.getRootElement().getChild("simulation");
+    if (simulation == null) {
+      throw new IOException("No simulation in " + template);
+    }
+
+    String makeArgs = substitute(property("make_args", ""), run.params);
+    for (Object o : simulation.getChildren("motetype")) {
+      Element motetype = (Element) o;
+      Element firmware = motetype.getChild("firmware");
+      Element commands = motetype.getChild("commands");
+      if (firmware == null || commands == null) {
+        continue;
+      }
+      File built = build(resolvePath(commands.getText(), template), makeArgs,
+          new File(resolvePath(firmware.getText(), template)));
+      firmware.setText(built.getAbsolutePath());
+      /* Nothing left to compile when the simulation is loaded */
+      motetype.removeChild("commands");
+    }
+
+    if (run.motes > 0) {
+      setMoteCount(simulation, run.motes, run.seed);
+    }
+
+    /* GUI plugins are not started without GUI, a script runs the test */
+    doc.getRootElement().removeChildren("plugin");
+    doc.getRootElement().addContent(scriptRunner());
+
+    run.dir.mkdirs();
+    FileWriter out = new FileWriter(new File(run.dir, SIMCONFIG_FILENAME));
+    try {
+      new XMLOutputter(Format.getPrettyFormat()).output(doc, out);
+    } finally {
+      out.close();
+    }
+  }
+
+  /**
+   * Builds the firmware of a mote type, once per distinct command line. Every
+   * configuration gets its own object directory, the make dependencies do not
+   * cover DEFINES.
+   */
+  private File build(String commands, String makeArgs, File firmware)
+  throws IOException, InterruptedException {
+    String key = commands + "\n" + makeArgs + "\n" + firmware;
+    File built = firmwares.get(key);
+    if (built != null) {
+      return built;
+    }
+
+    int id = firmwares.size();
+    File dir = firmware.getParentFile();
+    for (String line : commands.split("\n")) {
+      line = line.trim();
+      if (line.isEmpty()) {
+        continue;
+      }
+      if (line.startsWith("make ")) {
+        line += " OBJECTDIR=obj_batch_" + id + " " + makeArgs;
+      }
+      logger.info("Building: " + line);
+      ProcessBuilder pb = new ProcessBuilder("sh", "-c", line);
+      pb.directory(dir);
+      pb.redirectErrorStream(true);
+      pb.redirectOutput(new File(outputDir, "build-" + id + ".log"));
+      int ret = pb.start().waitFor();
+      if (ret != 0) {
+        throw new IOException("Build failed (" + ret + "), see build-" + id + ".log: " + line);
+      }
+    }
+
+    File copyDir = new File(outputDir, "firmware-" + id);
+    copyDir.mkdirs();
+    built = new File(copyDir, firmware.getName());
+    Files.copy(firmware.toPath(), built.toPath(), StandardCopyOption.REPLACE_EXISTING);
+    firmwares.put(key, built);
+    return built;
+  }
+
+  private static Element interfaceConfig(Element mote, String suffix) {
+    for (Object o : mote.getChildren("interface_config")) {
+      Element e = (Element) o;
+      if (e.getTextTrim().endsWith(suffix)) {
+        return e;
+      }
+    }
+    return null;
+  }
+
+  /**
+   * Keeps the first count motes, or adds clones of the last mote with the
+   * following IDs, placed at random inside the area of the template.
+   */
+  private static void setMoteCount(Element simulation, int count, long seed)
+  throws IOException {
+    @SuppressWarnings("unchecked")
+    List<Element> motes = new ArrayList<Element>(simulation.getChildren("mote"));
+    if (motes.isEmpty()) {
+      throw new IOException("Template has no motes");
+    }
+    for (int i = count; i < motes.size(); i++) {
+      simulation.removeContent(motes.get(i));
+    }
+    if (count <= motes.size()) {
+      return;
+    }
+
+    double minX = Double.MAX_VALUE, maxX = -Double.MAX_VALUE;
+    double minY = Double.MAX_VALUE, maxY = -Double.MAX_VALUE;
+    int maxId = 0;
+    for (Element mote : motes) {
+      Element pos = interfaceConfig(mote, ".Position");
+      if (pos != null) {
+        double x = Double.parseDouble(pos.getChildText("x"));
+        double y = Double.parseDouble(pos.getChildText("y"));
+        minX = Math.min(minX, x);
+        maxX = Math.max(maxX, x);
+        minY = Math.min(minY, y);
+        maxY = Math.max(maxY, y);
+      }
+      Element id = interfaceConfig(mote, "MoteID");
+      if (id != null) {
+        maxId = Math.max(maxId, Integer.parseInt(id.getChildText("id")));
+      }
+    }
+
+    Random random = new Random(seed);
+    Element last = motes.get(motes.size() - 1);
+    for (int i = motes.size(); i < count; i++) {
+      Element mote = (Element) last.clone();
+      Element pos = interfaceConfig(mote, ".Position");
+      if (pos != null && minX <= maxX) {
+        pos.getChild("x").setText(String.valueOf(minX + random.nextDouble() * (maxX - minX)));
+        pos.getChild("y").setText(String.valueOf(minY + random.nextDouble() * (maxY - minY)));
+      }
+      Element id = interfaceConfig(mote, "MoteID");
+      if (id != null) {
+        id.getChild("id").setText(String.valueOf(++maxId));
+      }
+      simulation.addContent(mote);
+    }
+  }
+
+  private Element scriptRunner() throws IOException {
+    long duration = Long.parseLong(property("duration", "600")) * 1000;
+    String script =
+      "TIMEOUT(" + duration + ", log.testOK());\n" +
+      "while(true) {\n" +
+      "  YIELD();\n" +
+      "  log.log(time + \"\\t\" + id + \"\\t\" + msg + \"\\n\");\n" +
+      "}\n";
+
+    Element plugin = new Element("plugin");
+    plugin.setText("org.contikios.cooja.plugins.ScriptRunner");
+    Element config = new Element("plugin_config");
+    Element scriptElement = new Element("script");
+    scriptElement.setText(script);
+    config.addContent(scriptElement);
+    Element active = new Element("active");
+    active.setText("true");
+    config.addContent(active);
+    plugin.addContent(config);
+    return plugin;
+  }
+
+  private void simulate(Run run) {
+    String java = System.getProperty("java.home") + File.separator + "bin" + File.separator + "java";
+    ProcessBuilder pb = new ProcessBuilder(java, "-jar", coojaJar.getAbsolutePath(),
+        "-nogui=" + SIMCONFIG_FILENAME,
+        "-contiki=" + contikiDir.getAbsolutePath(),
+        "-random-seed=" + run.seed);
+    pb.directory(run.dir);
+    pb.redirectErrorStream(true);
+    pb.redirectOutput(new File(run.dir, COOJA_LOG_FILENAME));
+    try {
+      logger.info("Starting run " + run.index + ": " + run.params + " motes=" + run.motes + " seed=" + run.seed);
+      run.exitValue = pb.start().waitFor();
+      logger.info("Run " + run.index + " finished: " + (run.exitValue == 0 ? "OK" : "FAILED"));
+    } catch (Exception e) {
+      logger.error("Run " + run.index + " could not be started: " + e.getMessage());
+    }
+  }
+
+  private static String csv(String field) {
+    if (field.contains(",") || field.contains("\"") || field.contains("\n")) {
+      return "\"" + field.replace("\"", "\"\"") + "\"";
+    }
+    return field;
+  }
+
+  /* One row per matching mote output line of every run, in run order */
+  private boolean merge(List<Run> runs) throws IOException {
+    Pattern filter = Pattern.compile(property("filter", "(.*)"));
+    String[] columns = split(property("columns", "message"));
+    boolean ok = true;
+
+    File results = new File(outputDir, RESULTS_FILENAME);
+    PrintWriter out = new PrintWriter(new FileWriter(results));
+    try {
+      StringBuilder header = new StringBuilder("run,seed,motes");
+      for (String name : params.keySet()) {
+        header.append(',').append(csv(name));
+      }
+      header.append(",time,mote");
+      for (String name : columns) {
+        header.append(',').append(csv(name));
+      }
+      out.println(header);
+
+      for (Run run : runs) {
+        if (run.exitValue != 0) {
+          logger.warn("Run " + run.index + " failed, see " + new File(run.dir, COOJA_LOG_FILENAME));
+          ok = false;
+        }
+        File log = new File(run.dir, TEST_LOG_FILENAME);
+        if (!log.exists()) {
+          continue;
+        }
+        StringBuilder prefix = new StringBuilder();
+        prefix.append(run.index).append(',').append(run.seed).append(',').append(run.motes);
+        for (String value : run.params.values()) {
+          prefix.append(',').append(csv(value));
+        }
+
+        BufferedReader in = new BufferedReader(new FileReader(log));
+        try {
+          String line;
+          while ((line = in.readLine()) != null) {
+            String[] fields = line.split("\t", 3);
+            if (fields.length < 3) {
+              continue;
+            }
+            Matcher m = filter.matcher(fields[2]);
+            if (!m.find()) {
+              continue;
+            }
+            StringBuilder row = new StringBuilder(prefix);
+            row.append(',').append(fields[0]).append(',').append(fields[1]);
+            for (int i = 1; i <= columns.length; i++) {
+              String value = i <= m.groupCount() ? m.group(i) : "";
+              row.append(',').append(csv(value != null ? value : ""));
+            }
+            out.println(row);
+          }
+        } finally {
+          in.close();
+        }
+      }
+    } finally {
+      out.close();
+    }
+    logger.info("Results written to " + results);
+    return ok;
+  }
+}